@@ -30,12 +30,27 @@ void vsc::BaseConfig::Read(const std::string& fileName)
     std::ifstream f(fileName.c_str());
     if(!f.is_open())
         THROW_VSC_EXCEPTION("Read file error", "Unable to read the configuration file '" << fileName << "'.");
+    sections.clear();
+    sectionNames.clear();
+    Map* currentSection = &parameters;
     while(f.good()) {
         std::string line;
         std::getline(f, line);
         if(!line.length() || line[0] == '#' || line[0] == '-')
             continue;
 
+        if(line[0] == '[') {
+            const size_t end = line.find(']');
+            if(end == std::string::npos || end == 1)
+                THROW_VSC_EXCEPTION("Configuration error", "Invalid section header '" << line
+                                    << "' in the configuration file '" << fileName << "'.");
+            const std::string sectionName = line.substr(1, end - 1);
+            if(!sections.count(sectionName))
+                sectionNames.push_back(sectionName);
+            currentSection = &sections[sectionName];
+            continue;
+        }
+
         std::istringstream istring( line);
         std::string name;
         std::string value;
@@ -44,8 +59,63 @@ void vsc::BaseConfig::Read(const std::string& fileName)
 
         if(istring.fail() || !name.length())
             continue;
-        parameters[name] = value;
+        (*currentSection)[name] = value;
+    }
+
+    const std::string invalidParameters = LoadParameters(true);
+    if(!invalidParameters.empty())
+        THROW_VSC_EXCEPTION("Configuration error", "Invalid values in the configuration file '" << fileName << "':"
+                            << invalidParameters << ". Default values are used instead.");
+}
+
+std::vector<std::string> vsc::BaseConfig::FileParameterNames() const
+{
+    std::vector<std::string> names;
+    for(Map::const_iterator iter = parameters.begin(); iter != parameters.end(); ++iter) {
+        if(!programParameters.count(iter->first))
+            names.push_back(iter->first);
     }
+    return names;
+}
+
+std::vector<std::string> vsc::BaseConfig::SectionNames(const std::string& prefix) const
+{
+    std::vector<std::string> result;
+    for(const std::string& name : sectionNames) {
+        if(!name.compare(0, prefix.size(), prefix))
+            result.push_back(name);
+    }
+    return result;
+}
+
+void vsc::BaseConfig::LoadSection(const BaseConfig& other, const std::string& sectionName)
+{
+    const SectionMap::const_iterator iter = other.sections.find(sectionName);
+    if(iter == other.sections.end())
+        THROW_VSC_EXCEPTION("Configuration error", "Configuration section '" << sectionName << "' not found.");
+    parameters = iter->second;
+    const std::string invalidParameters = LoadParameters(true);
+    if(!invalidParameters.empty())
+        THROW_VSC_EXCEPTION("Configuration error", "Invalid values in the configuration section '" << sectionName
+                            << "':" << invalidParameters << ". Default values are used instead.");
+}
+
+void vsc::BaseConfig::CopyParameters(const BaseConfig& other)
+{
+    parameters = other.parameters;
+    programParameters = other.programParameters;
+    sections = other.sections;
+    sectionNames = other.sectionNames;
+    LoadParameters(true);
+}
+
+void vsc::BaseConfig::CopyProgramParameters(const BaseConfig& other)
+{
+    for(Map::const_iterator iter = other.programParameters.begin(); iter != other.programParameters.end(); ++iter) {
+        parameters[iter->first] = iter->second;
+        programParameters[iter->first] = iter->second;
+    }
+    LoadParameters(false);
 }
 
 void vsc::BaseConfig::Write(const std::string& fileName) const
@@ -57,4 +127,24 @@ void vsc::BaseConfig::Write(const std::string& fileName) const
     for(Map::const_iterator iter = parameters.begin(); iter != parameters.end(); ++iter) {
         f << iter->first << " " << iter->second << std::endl;
     }
+    for(const std::string& sectionName : sectionNames) {
+        f << std::endl << "[" << sectionName << "]" << std::endl;
+        const Map& section = sections.at(sectionName);
+        for(Map::const_iterator iter = section.begin(); iter != section.end(); ++iter)
+            f << iter->first << " " << iter->second << std::endl;
+    }
+}
+
+std::string vsc::BaseConfig::LoadParameters(bool loadMissing)
+{
+    std::ostringstream invalidParameters;
+    for(BaseConfigInternals::ParameterBase* parameter : registeredParameters) {
+        const Map::const_iterator iter = parameters.find(parameter->Name());
+        if(iter == parameters.end()) {
+            if(loadMissing)
+                parameter->Load(nullptr);
+        } else if(!parameter->Load(&iter->second))
+            invalidParameters << " " << parameter->Name() << "='" << iter->second << "'";
+    }
+    return invalidParameters.str();
 }
@@ -24,6 +24,8 @@
 #pragma once
 
 #include <map>
+#include <vector>
+#include <boost/utility.hpp>
 #include "log.h"
 #include "units.h"
 
@@ -36,14 +38,11 @@
 
 
 #define VSC_CONFIG_PARAMETER(type, name, default_value) \
-    type name() const { \
-        type result = default_value; \
-        if(!Get(#name, result)) \
-            vsc::LogInfo(ConfigName()) << "Warning: Parameter '" << #name \
-                                       << "' is not set. Using default value = '" << default_value << "'.\n"; \
-        return result; \
-    } \
-    void set##name(const type& value) { Set(#name, value); }
+    private: \
+        vsc::ConfigParameter<type> name##Parameter{*this, ConfigName(), #name, default_value}; \
+    public: \
+        const type& name() const { return name##Parameter.Value(); } \
+        void set##name(const type& value) { Set(#name, value); name##Parameter.Update(value); }
 
 namespace vsc {
 
@@ -58,6 +57,19 @@ struct ConfigValue {
     }
 };
 
+template<>
+struct ConfigValue<bool> {
+    static bool Read(const std::string& str, bool& value) {
+        if(str == "true" || str == "1")
+            value = true;
+        else if(str == "false" || str == "0")
+            value = false;
+        else
+            return false;
+        return true;
+    }
+};
+
 template<>
 struct ConfigValue<vsc::ElectricCurrent> {
     static const vsc::ElectricCurrent& UnitsFactor() {
@@ -106,16 +118,99 @@ struct ConfigValue<vsc::Time> {
     }
 };
 
+template<>
+struct ConfigValue<vsc::Resistance> {
+    static const vsc::Resistance& UnitsFactor() {
+        static const vsc::Resistance factor = 1.0 * vsc::ohms;
+        return factor;
+    }
+
+    static bool Read(const std::string& str, vsc::Resistance& value) {
+        double v;
+        if(!ConfigValue<double>::Read(str, v))
+            return false;
+        value = v * UnitsFactor();
+        return true;
+    }
+};
+
+template<>
+struct ConfigValue<vsc::Capacitance> {
+    static const vsc::Capacitance& UnitsFactor() {
+        static const vsc::Capacitance factor = 1.0 * vsc::farads;
+        return factor;
+    }
+
+    static bool Read(const std::string& str, vsc::Capacitance& value) {
+        double v;
+        if(!ConfigValue<double>::Read(str, v))
+            return false;
+        value = v * UnitsFactor();
+        return true;
+    }
+};
+
+/// Interface used by BaseConfig to load the typed parameter values.
+class ParameterBase {
+public:
+    virtual ~ParameterBase() {}
+    virtual const std::string& Name() const = 0;
+
+    /*!
+     * \brief Set the parameter value from its text representation.
+     * \param str - the text representation or nullptr if the parameter is not set.
+     * \return false if the text can't be converted into the parameter value.
+     */
+    virtual bool Load(const std::string* str) = 0;
+};
+
 }
 
-class BaseConfig {
+/*!
+ * \brief Base class for configurations.
+ *
+ * Each parameter declared with VSC_CONFIG_PARAMETER keeps its typed value, which is parsed only when the
+ * configuration file is read or when the parameter is set. Therefore the parameter getters are plain field accesses
+ * and can be used at any rate.
+ *
+ * The file can contain named sections that start with a "[name]" line. Parameters that follow a section header belong
+ * to that section and can be loaded into a separate configuration object with LoadSection.
+ */
+class BaseConfig : private boost::noncopyable {
 private:
     typedef std::map<std::string, std::string> Map;
+    typedef std::map<std::string, Map> SectionMap;
 public:
     virtual ~BaseConfig() {}
+
+    /*!
+     * \brief Read the configuration file and update all parameters.
+     * \throw vsc::exception if the file can't be read or contains invalid parameter values.
+     */
     virtual void Read(const std::string& fileName);
     virtual void Write(const std::string& fileName) const;
 
+    /// Set all parameters and sections of another configuration.
+    void CopyParameters(const BaseConfig& other);
+
+    /// Set the parameters that were set by the program in another configuration, i.e. not read from a file.
+    void CopyProgramParameters(const BaseConfig& other);
+
+    /// Returns names of the parameters that are read from a file or a section, i.e. not set by the program.
+    std::vector<std::string> FileParameterNames() const;
+
+    /// Returns names of the sections that start with \a prefix in the order they appear in the file.
+    std::vector<std::string> SectionNames(const std::string& prefix = "") const;
+
+    /*!
+     * \brief Set all parameters from a section of another configuration.
+     * \throw vsc::exception if the section is not found or contains invalid parameter values.
+     */
+    void LoadSection(const BaseConfig& other, const std::string& sectionName);
+
+    /// Register a typed parameter. Called by the parameters declared with VSC_CONFIG_PARAMETER.
+    void Register(BaseConfigInternals::ParameterBase& parameter) { registeredParameters.push_back(&parameter); }
+
 protected:
     template<typename Value>
     bool Get(const std::string& name, Value& value) const {
@@ -130,10 +225,64 @@ protected:
         std::ostringstream s;
         s << value;
         parameters[name] = s.str();
+        programParameters[name] = s.str();
     }
 
+private:
+    std::string LoadParameters(bool loadMissing);
+
 private:
     Map parameters;
+    Map programParameters;
+    SectionMap sections;
+    std::vector<std::string> sectionNames;
+    std::vector<BaseConfigInternals::ParameterBase*> registeredParameters;
+};
+
+/*!
+ * \brief A typed configuration parameter.
+ *
+ * The value is initialized with the default value and replaced when the configuration is read. If the parameter is not
+ * set in the configuration, a warning is reported once per read.
+ */
+template<typename Type>
+class ConfigParameter : public BaseConfigInternals::ParameterBase {
+public:
+    template<typename DefaultValue>
+    ConfigParameter(BaseConfig& config, const std::string& _configName, const std::string& _name,
+                    const DefaultValue& _defaultValue)
+        : configName(_configName), name(_name), defaultValue(_defaultValue), value(defaultValue)
+    {
+        config.Register(*this);
+    }
+
+    const Type& Value() const { return value; }
+    void Update(const Type& _value) { value = _value; }
+
+    virtual const std::string& Name() const { return name; }
+
+    virtual bool Load(const std::string* str)
+    {
+        if(!str) {
+            vsc::LogInfo(configName) << "Warning: Parameter '" << name << "' is not set. Using default value = '"
+                                     << defaultValue << "'.\n";
+            value = defaultValue;
+            return true;
+        }
+        Type newValue;
+        if(!BaseConfigInternals::ConfigValue<Type>::Read(*str, newValue)) {
+            value = defaultValue;
+            return false;
+        }
+        value = newValue;
+        return true;
+    }
+
+private:
+    const std::string& configName;
+    std::string name;
+    Type defaultValue;
+    Type value;
 };
 
 }
@@ -23,13 +23,68 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include "BaseConfig.h"
 
 #define VSC_FULL_CONFIG_FILE_NAME(name) \
     std::string Full##name() const { return FullFileName(name()); }
 
+/*!
+ * \brief Configuration of a voltage source defined in a "[source.name]" section of the configuration file.
+ */
+class VoltageSourceConfig : public vsc::BaseConfig {
+public:
+    VSC_CONFIG_PARAMETER(std::string, Driver, "Keithley237")
+    VSC_CONFIG_PARAMETER(std::string, Device, "keithley")
+    VSC_CONFIG_PARAMETER(bool, SetToLocalModeOnExit, true)
+    VSC_CONFIG_PARAMETER(unsigned, NumberOfReadingsToAverage, 4)
+    VSC_CONFIG_PARAMETER(vsc::Time, IntegrationTime, 16.670e-3 * vsc::seconds)
+    VSC_CONFIG_PARAMETER(vsc::Time, MeasurementInterval, 1.0 * vsc::seconds)
+    VSC_CONFIG_PARAMETER(std::string, Faults, "")
+    VSC_CONFIG_PARAMETER(unsigned, FaultSeed, 1)
+    VSC_CONFIG_PARAMETER(vsc::Time, FaultLatencySpike, 1.0 * vsc::seconds)
+    VSC_CONFIG_PARAMETER(vsc::Time, FaultTimeout, 3.0 * vsc::seconds)
+    VSC_CONFIG_PARAMETER(vsc::Time, FaultReconnectTime, 10.0 * vsc::seconds)
+    VSC_CONFIG_PARAMETER(std::string, MeasurementRing, "")
+    VSC_CONFIG_PARAMETER(unsigned, MeasurementRingCapacity, 4096)
+    VSC_CONFIG_PARAMETER(unsigned, EventSource, 0)
+
+public:
+    /// Prefix of the configuration sections that describe voltage sources.
+    static const std::string& SectionPrefix() {
+        static const std::string prefix = "source.";
+        return prefix;
+    }
+
+    explicit VoltageSourceConfig(const std::string& _name) : name(_name) {}
+
+    /// Returns the name of the voltage source, i.e. the section name without the prefix.
+    const std::string& Name() const { return name; }
+
+    /// Returns a driver-specific parameter that is not declared above or \a defaultValue if it is not set.
+    template<typename Value>
+    Value ExtraParameter(const std::string& parameterName, const Value& defaultValue) const {
+        Value value;
+        return Get(parameterName, value) ? value : defaultValue;
+    }
+
+private:
+    VSC_CONFIG_NAME("VoltageSourceConfig")
+    std::string name;
+};
+
 /*!
  * \brief Configuration parameters
+ *
+ * Singleton returns the current snapshot of the configuration. A published snapshot is never modified: Reload and
+ * Update build a new snapshot and publish it under a mutex, so the readers on other threads never see a partially
+ * updated configuration. Each thread caches a shared pointer to the snapshot it used last and takes the mutex only
+ * after a new snapshot is published, so otherwise Singleton costs a single atomic load. The previous snapshot is
+ * destroyed after the last thread releases it.
  */
 class ConfigParameters : public vsc::BaseConfig {
 public:
@@ -40,26 +95,136 @@ public:
     VSC_FULL_CONFIG_FILE_NAME(DebugFileName)
     VSC_CONFIG_PARAMETER(std::string, LogFileName, "info.log")
     VSC_FULL_CONFIG_FILE_NAME(LogFileName)
+    VSC_CONFIG_PARAMETER(std::string, EventLogFileName, "events.vscev")
+    VSC_FULL_CONFIG_FILE_NAME(EventLogFileName)
+    VSC_CONFIG_PARAMETER(bool, EventLogging, true)
+    VSC_CONFIG_PARAMETER(bool, DebugLogging, true)
+    VSC_CONFIG_PARAMETER(bool, AsynchronousLogging, true)
+    VSC_CONFIG_PARAMETER(unsigned, LogFlushSize, 65536)
+    VSC_CONFIG_PARAMETER(vsc::Time, LogFlushInterval, 0.5 * vsc::seconds)
+    VSC_CONFIG_PARAMETER(bool, Tracing, false)
+    VSC_CONFIG_PARAMETER(unsigned, TraceBufferSize, 65536)
+    VSC_CONFIG_PARAMETER(std::string, TraceFileName, "trace.json")
+    VSC_FULL_CONFIG_FILE_NAME(TraceFileName)
 
     VSC_CONFIG_PARAMETER(std::string, VoltageSource, "Keithley237")
     VSC_CONFIG_PARAMETER(std::string, VoltageSourceDevice, "keithley")
     VSC_CONFIG_PARAMETER(bool, SetVoltageSourceToLocalModeOnExit, true)
     VSC_CONFIG_PARAMETER(unsigned, NumberOfVoltageSourceReadingsToAverage, 4)
     VSC_CONFIG_PARAMETER(vsc::Time, VoltageSourceIntegrationTime, 16.670e-3 * vsc::seconds)
+    VSC_CONFIG_PARAMETER(vsc::Time, VoltageSourceMeasurementInterval, 1.0 * vsc::seconds)
+    VSC_CONFIG_PARAMETER(vsc::Time, RampSpinInterval, 200e-6 * vsc::seconds)
+    VSC_CONFIG_PARAMETER(bool, ReloadOnConfigFileChange, true)
+    VSC_CONFIG_PARAMETER(std::string, DriverPluginDirectory, "plugins")
+    VSC_FULL_CONFIG_FILE_NAME(DriverPluginDirectory)
+    VSC_CONFIG_PARAMETER(std::string, ControlSocketFileName, "vsc.sock")
+    VSC_FULL_CONFIG_FILE_NAME(ControlSocketFileName)
+    VSC_CONFIG_PARAMETER(bool, DaemonConnectOnStart, true)
+    VSC_CONFIG_PARAMETER(unsigned, MetricsPort, 0)
+    VSC_CONFIG_PARAMETER(std::string, ControllerSource, "")
 
 public:
-    static ConfigParameters& ModifiableSingleton() {
-        static ConfigParameters instance;
-        return instance;
+    /// Pointer to a configuration snapshot.
+    typedef std::shared_ptr<const ConfigParameters> Pointer;
+
+    /*!
+     * \brief Returns the current snapshot.
+     *
+     * The returned pointer is cached by the calling thread and is replaced by its next call after a new snapshot is
+     * published. A copy of the pointer should be kept to use the same snapshot across several calls.
+     */
+    static const Pointer& Singleton() {
+        thread_local CachedSnapshot cache;
+        if(cache.version != Version().load(std::memory_order_acquire)) {
+            const std::lock_guard<std::mutex> lock(Mutex());
+            cache.snapshot = Current();
+            cache.version = Version().load(std::memory_order_relaxed);
+        }
+        return cache.snapshot;
+    }
+
+    /*!
+     * \brief Apply changes made by the program to a copy of the current snapshot and make it current.
+     * \param modify - sets the parameters of the new snapshot; if it throws, the current snapshot is kept.
+     *
+     * The parameters set by \a modify are kept by the following Reload calls.
+     */
+    static void Update(const std::function<void (ConfigParameters&)>& modify) {
+        const std::lock_guard<std::mutex> lock(Mutex());
+        std::shared_ptr<ConfigParameters> snapshot(new ConfigParameters());
+        snapshot->CopyParameters(*Current());
+        modify(*snapshot);
+        Publish(snapshot);
     }
 
-    static const ConfigParameters& Singleton() {
-        return ModifiableSingleton();
+    /*!
+     * \brief Read the configuration file into a new snapshot and make it current.
+     * \throw vsc::exception if the file can't be read or contains invalid values. The current snapshot is kept.
+     *
+     * The values that were set by the program and are not present in the file are kept. The parameters that were
+     * removed from the file return to their default values.
+     */
+    static void Reload() {
+        const std::lock_guard<std::mutex> lock(Mutex());
+        std::shared_ptr<ConfigParameters> snapshot(new ConfigParameters());
+        snapshot->CopyProgramParameters(*Current());
+        snapshot->ReadConfigParameterFile();
+        Publish(snapshot);
     }
 
 public:
     void ReadConfigParameterFile() {
-        Read(FullFileName(fileName));
+        Read(FullConfigFileName());
+    }
+
+    std::string FullConfigFileName() const {
+        return FullFileName(fileName);
+    }
+
+    /// Returns the configuration of the voltage source defined by the VoltageSource* parameters.
+    std::shared_ptr<VoltageSourceConfig> DefaultVoltageSource() const {
+        std::shared_ptr<VoltageSourceConfig> config(new VoltageSourceConfig("default"));
+        config->setDriver(VoltageSource());
+        config->setDevice(VoltageSourceDevice());
+        config->setSetToLocalModeOnExit(SetVoltageSourceToLocalModeOnExit());
+        config->setNumberOfReadingsToAverage(NumberOfVoltageSourceReadingsToAverage());
+        config->setIntegrationTime(VoltageSourceIntegrationTime());
+        config->setMeasurementInterval(VoltageSourceMeasurementInterval());
+        return config;
+    }
+
+    /*!
+     * \brief Returns the configuration of the voltage source operated by the Controller.
+     * \throw vsc::exception if the section is not found or contains invalid values.
+     *
+     * If ControllerSource is set, the configuration is read from the "[source.<ControllerSource>]" section, otherwise
+     * DefaultVoltageSource is returned.
+     */
+    std::shared_ptr<VoltageSourceConfig> ControllerVoltageSource() const {
+        if(ControllerSource().empty())
+            return DefaultVoltageSource();
+        std::shared_ptr<VoltageSourceConfig> config(new VoltageSourceConfig(ControllerSource()));
+        config->LoadSection(*this, VoltageSourceConfig::SectionPrefix() + ControllerSource());
+        return config;
+    }
+
+    /*!
+     * \brief Returns configurations of all voltage sources defined in "[source.name]" sections.
+     * \throw vsc::exception if a section contains invalid values.
+     *
+     * If there are no such sections, the result contains only DefaultVoltageSource.
+     */
+    std::vector<std::shared_ptr<VoltageSourceConfig>> VoltageSources() const {
+        std::vector<std::shared_ptr<VoltageSourceConfig>> result;
+        const std::string& prefix = VoltageSourceConfig::SectionPrefix();
+        for(const std::string& sectionName : SectionNames(prefix)) {
+            std::shared_ptr<VoltageSourceConfig> config(new VoltageSourceConfig(sectionName.substr(prefix.size())));
+            config->LoadSection(*this, sectionName);
+            result.push_back(config);
+        }
+        if(result.empty())
+            result.push_back(DefaultVoltageSource());
+        return result;
     }
 
     void WriteConfigParameterFile() const {
@@ -70,6 +235,38 @@ private:
     std::string FullFileName(const std::string& fileName) const {
         return Directory() + "/" + fileName;
     }
+
+    /// The snapshot cached by a thread and the version under which it was published.
+    struct CachedSnapshot {
+        uint64_t version;
+        Pointer snapshot;
+
+        CachedSnapshot() : version(0) {}
+    };
+
+    /// Guards Current. Taken by the writers and by the readers that refresh their cached snapshot.
+    static std::mutex& Mutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static Pointer& Current() {
+        static Pointer current(new ConfigParameters());
+        return current;
+    }
+
+    /// Incremented each time a snapshot is published. Starts from 1, so the cache of a new thread is refreshed.
+    static std::atomic<uint64_t>& Version() {
+        static std::atomic<uint64_t> version(1);
+        return version;
+    }
+
+    /// Make the snapshot current. Should be called with Mutex taken.
+    static void Publish(const Pointer& snapshot) {
+        Current() = snapshot;
+        Version().fetch_add(1, std::memory_order_release);
+    }
+
     VSC_CONFIG_NAME("ConfigParameters")
     ConfigParameters() : fileName("parameters.cfg") {}
     std::string fileName;
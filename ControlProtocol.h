@@ -0,0 +1,186 @@
+/*!
+ * \file ControlProtocol.h
+ * \brief Binary protocol of the control socket.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace vsc {
+namespace control {
+
+/*!
+ * \brief Types of the messages exchanged over the control socket.
+ *
+ * Numbers are encoded in the native (little-endian) byte order, strings as a 16-bit length followed by characters.
+ */
+enum class MessageType : uint16_t {
+    /// Request to execute a controller command. Payload: uint8 Controller::Command value.
+    Command = 1,
+
+    /// Request of the current status. No payload.
+    StatusRequest = 2,
+
+    /// Reply to a request. Payload: uint8 success flag, string error message.
+    Reply = 3,
+
+    /*!
+     * Reply to StatusRequest. Payload: uint8 connected flag, uint8 has measurement flag, f64 voltage [V],
+     * f64 current [A], f64 timestamp [s], uint8 compliance flag, string last error message.
+     */
+    Status = 4,
+
+    /// Request to receive MeasurementBatch messages with all following measurements. No payload.
+    Subscribe = 5,
+
+    /// Request to stop sending MeasurementBatch messages. No payload.
+    Unsubscribe = 6,
+
+    /*!
+     * Measurements made since the previous batch; sent to the subscribed clients with zero request id.
+     * Payload: uint32 number of measurements followed by MeasurementRecord for each measurement.
+     */
+    MeasurementBatch = 7,
+
+    /*!
+     * Request to set the voltage, i.e. Controller::SetVoltageParameters followed by the EnableVoltage command.
+     * Payload: f64 voltage [V], f64 compliance [A], f64 ramp step [V] (zero to set at once), f64 delay between
+     * the ramp steps [s]. The voltage is turned off by the DisableVoltage command. The request fails if a value is
+     * not finite, the compliance is not positive, the step or the delay is negative, or the payload has extra bytes.
+     */
+    SetVoltage = 8,
+
+    /// Request of the latency histograms summary (see LatencyRegistry::Report). Reply message contains the table.
+    LatencyReport = 9
+};
+
+/// Header of each message. It is followed by \a payloadSize bytes of payload.
+struct FrameHeader {
+    uint16_t type;
+
+    /// Reserved for the future use. Always zero.
+    uint16_t reserved;
+
+    /// Identifier chosen by the client. Replies carry the identifier of their request.
+    uint32_t requestId;
+
+    uint32_t payloadSize;
+};
+
+/// A measurement in the MeasurementBatch message.
+#pragma pack(push, 1)
+struct MeasurementRecord {
+    /// Time in seconds on the steady clock of the server (see DateTimeProvider::ElapsedTime).
+    double timestamp;
+
+    /// Voltage in Volts.
+    double voltage;
+
+    /// Current in Amperes.
+    double current;
+
+    uint8_t compliance;
+};
+#pragma pack(pop)
+
+/// Maximal payload size of a request.
+const uint32_t MAX_REQUEST_PAYLOAD_SIZE = 4096;
+
+/// Appends a message to a buffer.
+class FrameWriter {
+public:
+    FrameWriter(std::vector<char>& _buffer, MessageType type, uint32_t requestId)
+        : buffer(_buffer), headerPosition(_buffer.size())
+    {
+        const FrameHeader header = { static_cast<uint16_t>(type), 0, requestId, 0 };
+        Append(header);
+    }
+
+    ~FrameWriter()
+    {
+        const uint32_t payloadSize = static_cast<uint32_t>(buffer.size() - headerPosition - sizeof(FrameHeader));
+        std::memcpy(buffer.data() + headerPosition + offsetof(FrameHeader, payloadSize), &payloadSize,
+                    sizeof(payloadSize));
+    }
+
+    template<typename Value>
+    FrameWriter& Append(const Value& value)
+    {
+        const char* data = reinterpret_cast<const char*>(&value);
+        buffer.insert(buffer.end(), data, data + sizeof(value));
+        return *this;
+    }
+
+    FrameWriter& AppendString(const std::string& str)
+    {
+        const uint16_t length = static_cast<uint16_t>(std::min<size_t>(str.size(), UINT16_MAX));
+        Append(length);
+        buffer.insert(buffer.end(), str.begin(), str.begin() + length);
+        return *this;
+    }
+
+private:
+    std::vector<char>& buffer;
+    size_t headerPosition;
+};
+
+/// Reads the fields of a message payload.
+class PayloadReader {
+public:
+    PayloadReader(const char* _data, size_t _size) : data(_data), size(_size), position(0) {}
+
+    template<typename Value>
+    bool Extract(Value& value)
+    {
+        if(position + sizeof(value) > size)
+            return false;
+        std::memcpy(&value, data + position, sizeof(value));
+        position += sizeof(value);
+        return true;
+    }
+
+    bool ExtractString(std::string& str)
+    {
+        uint16_t length;
+        if(!Extract(length) || position + length > size)
+            return false;
+        str.assign(data + position, length);
+        position += length;
+        return true;
+    }
+
+    /// Indicates if the whole payload is extracted.
+    bool AtEnd() const { return position == size; }
+
+private:
+    const char* data;
+    size_t size, position;
+};
+
+} // control
+} // vsc
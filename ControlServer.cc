@@ -0,0 +1,343 @@
+/*!
+ * \file ControlServer.cc
+ * \brief Implementation of ControlServer class.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "exception.h"
+#include "log.h"
+#include "ControlServer.h"
+#include "LatencyHistogram.h"
+#include "Trace.h"
+
+namespace {
+const std::string LOG_HEAD = "ControlServer";
+
+/// A client that does not read its replies is disconnected when its output exceeds this size.
+const size_t MAX_OUTPUT_SIZE = 16 * 1024 * 1024;
+}
+
+namespace vsc {
+
+ControlServer::ControlServer(Controller& _controller, const std::string& _socketFileName,
+                             const OnShutdownCallback& _onShutdown)
+    : controller(_controller), socketFileName(_socketFileName), onShutdown(_onShutdown), connected(false),
+      hasMeasurement(false)
+{
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if(socketFileName.size() >= sizeof(address.sun_path))
+        THROW_VSC_EXCEPTION("Control socket error", "Socket file name '" << socketFileName << "' is too long.");
+    std::strncpy(address.sun_path, socketFileName.c_str(), sizeof(address.sun_path) - 1);
+
+    listenDescriptor = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(listenDescriptor < 0)
+        THROW_VSC_EXCEPTION("Control socket error", "Unable to create a socket. " << std::strerror(errno));
+    unlink(socketFileName.c_str());
+    if(bind(listenDescriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+            || listen(listenDescriptor, SOMAXCONN) != 0) {
+        const int error = errno;
+        close(listenDescriptor);
+        THROW_VSC_EXCEPTION("Control socket error", "Unable to listen on '" << socketFileName << "'. "
+                            << std::strerror(error));
+    }
+    if(pipe(stopPipe) != 0) {
+        const int error = errno;
+        close(listenDescriptor);
+        unlink(socketFileName.c_str());
+        THROW_VSC_EXCEPTION("Control socket error", "Unable to create a pipe. " << std::strerror(error));
+    }
+    wakeDescriptor = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(wakeDescriptor < 0) {
+        const int error = errno;
+        close(stopPipe[0]);
+        close(stopPipe[1]);
+        close(listenDescriptor);
+        unlink(socketFileName.c_str());
+        THROW_VSC_EXCEPTION("Control socket error", "Unable to create an eventfd. " << std::strerror(error));
+    }
+
+    using namespace std::placeholders;
+    controller.AddOnConnectSuccessfulCallback(std::bind(&ControlServer::onConnected, this, true));
+    controller.AddOnDisconnectSuccessfulCallback(std::bind(&ControlServer::onConnected, this, false));
+    controller.AddOnDisconnectFailedCallback([this](const vsc::exception& e) { onConnected(false); onError(e); });
+    controller.AddOnConnectFailedCallback(std::bind(&ControlServer::onError, this, _1));
+    controller.AddOnErrorCallback(std::bind(&ControlServer::onError, this, _1));
+    controller.AddOnMeasurementCallback(std::bind(&ControlServer::onMeasurement, this, _1));
+
+    thread = std::thread(&ControlServer::Run, this);
+}
+
+ControlServer::~ControlServer()
+{
+    const char stop = 0;
+    if(write(stopPipe[1], &stop, 1) != 1)
+        LogError(LOG_HEAD) << "Unable to stop the server thread.\n";
+    thread.join();
+    for(const Client& client : clients)
+        close(client.descriptor);
+    close(stopPipe[0]);
+    close(stopPipe[1]);
+    close(wakeDescriptor);
+    close(listenDescriptor);
+    unlink(socketFileName.c_str());
+}
+
+void ControlServer::Run()
+{
+    Tracer::Singleton().SetThreadName("ControlServer");
+    std::vector<pollfd> descriptors;
+    for(;;) {
+        descriptors.clear();
+        descriptors.push_back({ stopPipe[0], POLLIN, 0 });
+        descriptors.push_back({ listenDescriptor, POLLIN, 0 });
+        descriptors.push_back({ wakeDescriptor, POLLIN, 0 });
+        for(const Client& client : clients) {
+            const short events = client.closed ? POLLOUT : client.output.empty() ? POLLIN : POLLIN | POLLOUT;
+            descriptors.push_back({ client.descriptor, events, 0 });
+        }
+
+        const int result = poll(descriptors.data(), descriptors.size(), -1);
+        if(result < 0 && errno == EINTR)
+            continue;
+        if(result < 0 || descriptors[0].revents)
+            return;
+        if(descriptors[1].revents)
+            Accept();
+        if(descriptors[2].revents)
+            Broadcast();
+
+        size_t n = 3;
+        for(auto iter = clients.begin(); iter != clients.end() && n < descriptors.size(); ++n) {
+            const short revents = descriptors[n].revents;
+            bool ok = !(revents & (POLLERR | POLLNVAL));
+            if(ok && !iter->closed && (revents & (POLLIN | POLLHUP)))
+                ok = Receive(*iter);
+            if(ok && !iter->output.empty())
+                ok = Transmit(*iter);
+            if(ok && iter->closed && iter->output.empty())
+                ok = false;
+            if(ok)
+                ++iter;
+            else {
+                close(iter->descriptor);
+                iter = clients.erase(iter);
+            }
+        }
+    }
+}
+
+void ControlServer::Accept()
+{
+    int descriptor;
+    while((descriptor = accept4(listenDescriptor, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+        Client client;
+        client.descriptor = descriptor;
+        client.subscribed = false;
+        client.closed = false;
+        clients.push_back(client);
+    }
+}
+
+bool ControlServer::Receive(Client& client)
+{
+    char buffer[4096];
+    for(;;) {
+        const ssize_t length = recv(client.descriptor, buffer, sizeof(buffer), 0);
+        if(length > 0) {
+            client.input.insert(client.input.end(), buffer, buffer + length);
+            continue;
+        }
+        if(length < 0 && errno == EINTR)
+            continue;
+        if(length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        if(length < 0)
+            return false;
+        // The requests received before the end of the stream are still handled and their replies are sent.
+        client.closed = true;
+        client.subscribed = false;
+        break;
+    }
+
+    size_t position = 0;
+    while(client.input.size() - position >= sizeof(control::FrameHeader)) {
+        control::FrameHeader header;
+        std::memcpy(&header, client.input.data() + position, sizeof(header));
+        if(header.payloadSize > control::MAX_REQUEST_PAYLOAD_SIZE)
+            return false;
+        if(client.input.size() - position - sizeof(header) < header.payloadSize)
+            break;
+        Handle(client, header, client.input.data() + position + sizeof(header));
+        position += sizeof(header) + header.payloadSize;
+    }
+    client.input.erase(client.input.begin(), client.input.begin() + position);
+    return client.output.size() <= MAX_OUTPUT_SIZE;
+}
+
+bool ControlServer::Transmit(Client& client)
+{
+    size_t position = 0;
+    while(position < client.output.size()) {
+        const ssize_t length = send(client.descriptor, client.output.data() + position,
+                                    client.output.size() - position, MSG_NOSIGNAL);
+        if(length > 0)
+            position += length;
+        else if(length < 0 && errno == EINTR)
+            continue;
+        else if(length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        else
+            return false;
+    }
+    client.output.erase(client.output.begin(), client.output.begin() + position);
+    return client.output.size() <= MAX_OUTPUT_SIZE;
+}
+
+void ControlServer::Broadcast()
+{
+    uint64_t counter;
+    if(read(wakeDescriptor, &counter, sizeof(counter)) < 0 && errno != EAGAIN)
+        LogError(LOG_HEAD) << "Unable to read the eventfd. " << std::strerror(errno) << "\n";
+    if(!measurementBridge.Pull(batch))
+        return;
+
+    batchFrame.clear();
+    {
+        control::FrameWriter writer(batchFrame, control::MessageType::MeasurementBatch, 0);
+        writer.Append(static_cast<uint32_t>(batch.size()));
+        for(const IVoltageSource::Measurement& measurement : batch) {
+            const control::MeasurementRecord record = { measurement.Timestamp / seconds, measurement.Voltage / volts,
+                                                        measurement.Current / amperes, measurement.Compliance };
+            writer.Append(record);
+        }
+    }
+    for(Client& client : clients) {
+        if(client.subscribed)
+            client.output.insert(client.output.end(), batchFrame.begin(), batchFrame.end());
+    }
+}
+
+void ControlServer::Handle(Client& client, const control::FrameHeader& header, const char* payload)
+{
+    control::PayloadReader reader(payload, header.payloadSize);
+    const control::MessageType type = static_cast<control::MessageType>(header.type);
+    if(type == control::MessageType::StatusRequest) {
+        WriteStatus(client, header.requestId);
+    } else if(type == control::MessageType::Command) {
+        uint8_t code;
+        if(!reader.Extract(code) || code > static_cast<uint8_t>(Controller::Command::ApplyConfiguration)) {
+            WriteReply(client, header.requestId, false, "Invalid command.");
+            return;
+        }
+        const Controller::Command command = static_cast<Controller::Command>(code);
+        if(command == Controller::Command::Exit) {
+            LogInfo(LOG_HEAD) << "Shutdown requested by a client.\n";
+            onShutdown();
+        } else
+            controller.SendCommand(command);
+        WriteReply(client, header.requestId, true, "");
+    } else if(type == control::MessageType::Subscribe || type == control::MessageType::Unsubscribe) {
+        client.subscribed = type == control::MessageType::Subscribe;
+        WriteReply(client, header.requestId, true, "");
+    } else if(type == control::MessageType::SetVoltage) {
+        double voltage, compliance, step, delay;
+        if(!reader.Extract(voltage) || !reader.Extract(compliance) || !reader.Extract(step)
+                || !reader.Extract(delay) || !reader.AtEnd()) {
+            WriteReply(client, header.requestId, false, "Invalid voltage parameters.");
+            return;
+        }
+        if(!std::isfinite(voltage) || !std::isfinite(compliance) || !std::isfinite(step) || !std::isfinite(delay)
+                || compliance <= 0 || step < 0 || delay < 0) {
+            WriteReply(client, header.requestId, false, "Voltage parameters should be finite, the compliance should be"
+                       " positive, the step and the delay should not be negative.");
+            return;
+        }
+        Controller::VoltageParameters parameters;
+        parameters.Value = IVoltageSource::Value(voltage * volts, compliance * amperes);
+        parameters.Step = step * volts;
+        parameters.DelayBetweenSteps = delay * seconds;
+        controller.SetVoltageParameters(parameters);
+        controller.SendCommand(Controller::Command::EnableVoltage);
+        WriteReply(client, header.requestId, true, "");
+    } else if(type == control::MessageType::LatencyReport) {
+        std::ostringstream report;
+        LatencyRegistry::Singleton().Report(report);
+        WriteReply(client, header.requestId, true, report.str());
+    } else
+        WriteReply(client, header.requestId, false, "Unknown request type.");
+}
+
+void ControlServer::WriteReply(Client& client, uint32_t requestId, bool success, const std::string& message)
+{
+    control::FrameWriter(client.output, control::MessageType::Reply, requestId)
+            .Append<uint8_t>(success).AppendString(message);
+}
+
+void ControlServer::WriteStatus(Client& client, uint32_t requestId)
+{
+    const std::lock_guard<std::mutex> lock(statusMutex);
+    control::FrameWriter(client.output, control::MessageType::Status, requestId)
+            .Append<uint8_t>(connected).Append<uint8_t>(hasMeasurement)
+            .Append<double>(lastMeasurement.Voltage / volts).Append<double>(lastMeasurement.Current / amperes)
+            .Append<double>(lastMeasurement.Timestamp / seconds).Append<uint8_t>(lastMeasurement.Compliance)
+            .AppendString(lastError);
+}
+
+void ControlServer::onConnected(bool _connected)
+{
+    const std::lock_guard<std::mutex> lock(statusMutex);
+    connected = _connected;
+    if(!connected)
+        hasMeasurement = false;
+}
+
+void ControlServer::onError(const vsc::exception& e)
+{
+    const std::lock_guard<std::mutex> lock(statusMutex);
+    lastError = e.message();
+}
+
+void ControlServer::onMeasurement(const IVoltageSource::Measurement& measurement)
+{
+    {
+        const std::lock_guard<std::mutex> lock(statusMutex);
+        lastMeasurement = measurement;
+        hasMeasurement = true;
+    }
+    const uint64_t increment = 1;
+    if(measurementBridge.Push(measurement) && write(wakeDescriptor, &increment, sizeof(increment)) < 0)
+        LogError(LOG_HEAD) << "Unable to wake up the server thread. " << std::strerror(errno) << "\n";
+}
+
+} // vsc
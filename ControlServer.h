@@ -0,0 +1,113 @@
+/*!
+ * \file ControlServer.h
+ * \brief Definition of ControlServer class.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <boost/utility.hpp>
+
+#include "Controller.h"
+#include "ControlProtocol.h"
+#include "MeasurementBridge.h"
+
+namespace vsc {
+/*!
+ * \brief Serves the control requests of the local clients over a Unix domain socket.
+ *
+ * Each client can send any number of requests (see control::MessageType); the replies are sent in the same order.
+ * The commands are passed to Controller::SendCommand, except the Exit command that calls the shutdown callback, so the
+ * owner of the controller can stop it in the right order. The socket is served by a single thread with non-blocking
+ * I/O, so a slow client does not delay the others.
+ *
+ * The measurements are passed from the controller thread through a MeasurementBridge. The server thread is woken up
+ * only when the bridge becomes non-empty, and it sends all measurements collected by then to each subscribed client
+ * as a single MeasurementBatch message, encoded once. The controller thread never waits for the clients: a client
+ * that does not read its messages is disconnected when its output buffer grows too large.
+ */
+class ControlServer : private boost::noncopyable {
+public:
+    typedef std::function<void ()> OnShutdownCallback;
+
+    /*!
+     * \brief Create the socket and start serving it.
+     * \throw vsc::exception if the socket can't be created.
+     *
+     * The server subscribes to the controller events, so it should be destroyed only after the controller thread is
+     * stopped.
+     */
+    ControlServer(Controller& controller, const std::string& socketFileName, const OnShutdownCallback& onShutdown);
+
+    /// Disconnect all clients, stop the server thread and remove the socket file.
+    ~ControlServer();
+
+private:
+    struct Client {
+        int descriptor;
+        bool subscribed;
+
+        /// Indicates that the client shut down its side of the connection. It is closed when the output is sent.
+        bool closed;
+        std::vector<char> input, output;
+    };
+
+private:
+    void Run();
+    void Accept();
+    bool Receive(Client& client);
+    bool Transmit(Client& client);
+    void Broadcast();
+    void Handle(Client& client, const control::FrameHeader& header, const char* payload);
+    void WriteReply(Client& client, uint32_t requestId, bool success, const std::string& message);
+    void WriteStatus(Client& client, uint32_t requestId);
+
+    void onConnected(bool connected);
+    void onError(const vsc::exception& e);
+    void onMeasurement(const IVoltageSource::Measurement& measurement);
+
+private:
+    Controller& controller;
+    std::string socketFileName;
+    OnShutdownCallback onShutdown;
+    int listenDescriptor;
+    int stopPipe[2];
+    int wakeDescriptor;
+    std::list<Client> clients;
+    MeasurementBridge measurementBridge;
+    std::vector<IVoltageSource::Measurement> batch;
+    std::vector<char> batchFrame;
+
+    std::mutex statusMutex;
+    bool connected, hasMeasurement;
+    IVoltageSource::Measurement lastMeasurement;
+    std::string lastError;
+
+    std::thread thread;
+};
+
+} // vsc
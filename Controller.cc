@@ -25,6 +25,22 @@
 #include <map>
 #include "Controller.h"
 #include "log.h"
+#include "EventLog.h"
+#include "date_time.h"
+#include "ConfigParameters.h"
+#include "Trace.h"
+
+namespace {
+const std::string LOG_HEAD = "Controller";
+const size_t MEASURE_INDEX = 6;
+const char* const COMMAND_NAMES[] = {
+    "Exit", "Connect", "Disconnect", "EnableVoltage", "DisableVoltage", "ApplyConfiguration", "Measure"
+};
+const char* const COMMAND_SPAN_NAMES[] = {
+    "Controller Exit", "Controller Connect", "Controller Disconnect", "Controller EnableVoltage",
+    "Controller DisableVoltage", "Controller ApplyConfiguration", "Controller Measure"
+};
+}
 
 namespace vsc {
 
@@ -38,13 +54,19 @@ Controller::CommandHandler Controller::GetCommandHandler(Command command)
         commandMap[Command::Disconnect] = &Controller::doDisconnect;
         commandMap[Command::EnableVoltage] = &Controller::doEnableVoltage;
         commandMap[Command::DisableVoltage] = &Controller::doDisableVoltage;
+        commandMap[Command::ApplyConfiguration] = &Controller::doApplyConfiguration;
     }
     return commandMap.at(command);
 }
 
 Controller::Controller()
-    : canRun(true), isRunning(false)
-{}
+    : nextMeasurementTime(0), canRun(true), isRunning(false), commandFailed(false)
+{
+    for(size_t n = 0; n < NUMBER_OF_COMMAND_STATISTICS; ++n) {
+        executedCommands[n] = 0;
+        failedCommands[n] = 0;
+    }
+}
 
 Controller::~Controller()
 {
@@ -58,19 +80,27 @@ Controller::~Controller()
 
 void Controller::operator()()
 {
+    Tracer::Singleton().SetThreadName("Controller");
     std::unique_lock<std::recursive_mutex> lock(mutex);
     isRunning = true;
     while(canRun) {
-        controlStateChange.wait(lock);
+        if(commandQueue.empty()) {
+            if(!voltageSource || voltageSource->GetClock().IsVirtual())
+                controlStateChange.wait(lock);
+            else {
+                const int64_t delay = nextMeasurementTime - voltageSource->GetClock().ElapsedNanoseconds();
+                controlStateChange.wait_for(lock, std::chrono::nanoseconds(delay));
+            }
+        }
+        // The virtual clock does not pass while the controller is idle, so it is advanced to the measurement time by
+        // doMeasure only before the queued commands are executed.
+        if(voltageSource && (voltageSource->GetClock().IsVirtual() ? !commandQueue.empty()
+                             : voltageSource->GetClock().ElapsedNanoseconds() >= nextMeasurementTime))
+            Execute(lock, &Controller::doMeasure, MEASURE_INDEX);
         while(commandQueue.size()) {
             const Command command = commandQueue.front();
             commandQueue.pop();
-            const CommandHandler handler = GetCommandHandler(command);
-            try {
-                (this->*handler)();
-            } catch(vsc::exception& e) {
-                Call(onError, e);
-            }
+            Execute(lock, GetCommandHandler(command), static_cast<size_t>(command));
         }
     }
 
@@ -87,9 +117,56 @@ void Controller::SendCommand(Command command)
     controlStateChange.notify_one();
 }
 
+void Controller::SetVoltageParameters(const VoltageParameters& parameters)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    voltageParameters = parameters;
+}
+
+std::vector<Controller::CommandStatistics> Controller::GetCommandStatistics() const
+{
+    std::vector<CommandStatistics> statistics;
+    for(size_t n = 0; n < NUMBER_OF_COMMAND_STATISTICS; ++n) {
+        const CommandStatistics commandStatistics = { COMMAND_NAMES[n], executedCommands[n].load(),
+                                                      failedCommands[n].load() };
+        statistics.push_back(commandStatistics);
+    }
+    return statistics;
+}
+
+size_t Controller::CommandQueueSize()
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    return commandQueue.size();
+}
+
+void Controller::Execute(std::unique_lock<std::recursive_mutex>& lock, CommandHandler handler, size_t commandIndex)
+{
+    // The lock protects only the command queue and the callbacks, so the commands can be queued while the handler
+    // waits for the device, e.g. during a long voltage ramp.
+    lock.unlock();
+    {
+        const TraceSpan span(COMMAND_SPAN_NAMES[commandIndex]);
+        commandFailed = false;
+        try {
+            (this->*handler)();
+        } catch(vsc::exception& e) {
+            commandFailed = true;
+            EventLog::Singleton().Error(e.message(), EventSource());
+            Call(onError, e);
+        }
+    }
+    executedCommands[commandIndex].fetch_add(1, std::memory_order_relaxed);
+    if(commandFailed)
+        failedCommands[commandIndex].fetch_add(1, std::memory_order_relaxed);
+    lock.lock();
+}
+
 void Controller::onVoltageSourceMeasurement(const IVoltageSource::Measurement& measurement)
 {
     Call(onMeasurement, measurement);
+    if(measurement.Compliance)
+        Call(onCompliance, measurement);
 }
 
 void Controller::doExit()
@@ -101,13 +178,23 @@ void Controller::doConnect()
 {
     if(voltageSource) {
         const vsc::exception e("Controller", "Connection error", "Program is already connected to the voltage source");
+        commandFailed = true;
         Call(onConnectFailed, e);
         return;
     }
+    std::shared_ptr<VoltageSourceConfig> config;
     try {
-        voltageSource = vsc::VoltageSourceFactory::Create();
+        DateTimeProvider::CalibrateWallClock();
+        config = ConfigParameters::Singleton()->ControllerVoltageSource();
+        voltageSource = vsc::VoltageSourceFactory::Create(*config);
+        voltageSource->SetOnMeasurementCallback(std::bind(&Controller::onVoltageSourceMeasurement, this,
+                                                          std::placeholders::_1));
+        voltageSourceConfig = config;
+        nextMeasurementTime = voltageSource->GetClock().ElapsedNanoseconds();
         Call(onConnectSuccessful);
     } catch(vsc::exception& e) {
+        commandFailed = true;
+        EventLog::Singleton().Error(e.message(), config ? static_cast<uint16_t>(config->EventSource()) : 0);
         Call(onConnectFailed, e);
     }
 }
@@ -119,19 +206,61 @@ void Controller::doDisconnect()
             voltageSource->Off();
         Call(onDisconnectSuccessful);
     } catch(vsc::exception& e) {
+        commandFailed = true;
+        EventLog::Singleton().Error(e.message(), EventSource());
         Call(onDisconnectFailed, e);
     }
     voltageSource = VoltageSourcePtr();
+    voltageSourceConfig.reset();
 }
 
 void Controller::doEnableVoltage()
 {
-
+    if(!voltageSource)
+        THROW_VSC_EXCEPTION("Not connected", "Program is not connected to the voltage source.");
+    VoltageParameters parameters;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        parameters = voltageParameters;
+    }
+    if(parameters.Step <= 0.0 * volts) {
+        voltageSource->Set(parameters.Value);
+        return;
+    }
+    if(!voltageSource->GradualSet(parameters.Value, parameters.Step, parameters.DelayBetweenSteps))
+        THROW_VSC_EXCEPTION("Compliance", "Voltage source went into compliance during the voltage ramp.");
 }
 
 void Controller::doDisableVoltage()
 {
+    if(voltageSource)
+        voltageSource->Off();
+}
+
+void Controller::doApplyConfiguration()
+{
+    if(!voltageSource)
+        return;
+    const ConfigParameters::Pointer configParameters = ConfigParameters::Singleton();
+    voltageSource->SetRampSpinInterval(configParameters->RampSpinInterval());
+    const std::shared_ptr<VoltageSourceConfig> config = configParameters->ControllerVoltageSource();
+    if(config->Name() != voltageSourceConfig->Name() || config->Driver() != voltageSourceConfig->Driver()
+            || config->Device() != voltageSourceConfig->Device()) {
+        LogInfo(LOG_HEAD) << "Voltage source '" << config->Name() << "' will be used after the reconnection.\n";
+        return;
+    }
+    voltageSource->SetMeasurementParameters(config->NumberOfReadingsToAverage(), config->IntegrationTime());
+    voltageSourceConfig = config;
+}
 
+void Controller::doMeasure()
+{
+    Clock& clock = voltageSource->GetClock();
+    if(clock.IsVirtual())
+        clock.SleepUntil(nextMeasurementTime, 0);
+    const Time interval = voltageSourceConfig->MeasurementInterval();
+    nextMeasurementTime = clock.ElapsedNanoseconds() + static_cast<int64_t>(interval / (nano * seconds));
+    voltageSource->Measure();
 }
 
 } // vsc
@@ -24,9 +24,11 @@
 
 #pragma once
 
+#include <atomic>
 #include <vector>
 #include <queue>
 #include <condition_variable>
+#include <chrono>
 #include <functional>
 #include "exception.h"
 #include "VoltageSourceFactory.h"
@@ -34,13 +36,31 @@
 namespace vsc {
 class Controller {
 public:
-    enum class Command { Exit, Connect, Disconnect, EnableVoltage, DisableVoltage };
+    enum class Command { Exit, Connect, Disconnect, EnableVoltage, DisableVoltage, ApplyConfiguration };
     typedef std::function<void (const IVoltageSource::Measurement&)> OnMeasurementCallback;
     typedef std::function<void (const vsc::exception&)> OnErrorCallback;
     typedef std::function<void ()> OnEventCallback;
     typedef VoltageSourceFactory::Pointer VoltageSourcePtr;
     typedef void (Controller::* CommandHandler)();
 
+    /// Number of times a command handler was executed and failed. The periodic measurement is counted as "Measure".
+    struct CommandStatistics {
+        std::string Name;
+        uint64_t Executed;
+        uint64_t Failed;
+    };
+
+    /// Parameters of the voltage that is set by the EnableVoltage command.
+    struct VoltageParameters {
+        IVoltageSource::Value Value;
+
+        /// Voltage step of the ramp. Zero step sets the voltage at once.
+        ElectricPotential Step;
+        Time DelayBetweenSteps;
+
+        VoltageParameters() : Step(0.0 * volts), DelayBetweenSteps(0.0 * seconds) {}
+    };
+
 private:
     typedef std::vector<OnMeasurementCallback> MeasurementCallbackVector;
     typedef std::vector<OnErrorCallback> ErrorCallbackVector;
@@ -48,6 +68,9 @@ private:
 
     static CommandHandler GetCommandHandler(Command command);
 
+    /// Commands and the periodic measurement.
+    static const size_t NUMBER_OF_COMMAND_STATISTICS = 7;
+
 public:
     Controller();
     ~Controller();
@@ -63,6 +86,15 @@ public:
     void operator()();
     void SendCommand(Command command);
 
+    /// Set the parameters used by the following EnableVoltage commands.
+    void SetVoltageParameters(const VoltageParameters& parameters);
+
+    /// Returns the statistics of all commands.
+    std::vector<CommandStatistics> GetCommandStatistics() const;
+
+    /// Returns the number of commands waiting to be executed.
+    size_t CommandQueueSize();
+
 private:
     void onVoltageSourceMeasurement(const IVoltageSource::Measurement& measurement);
 
@@ -76,16 +108,23 @@ private:
     template<typename CallbackVector, typename ...Arguments>
     void Call(const CallbackVector& callbacks, Arguments... arguments)
     {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
         for(const auto& callback : callbacks)
             callback(arguments...);
     }
 
+    void Execute(std::unique_lock<std::recursive_mutex>& lock, CommandHandler handler, size_t commandIndex);
+
+    /// Returns the event log source id of the connected voltage source or 0 if it is not connected.
+    uint16_t EventSource() const { return voltageSource ? voltageSource->EventSource() : 0; }
+
     void doExit();
     void doConnect();
     void doDisconnect();
     void doEnableVoltage();
     void doDisableVoltage();
-
+    void doApplyConfiguration();
+    void doMeasure();
 
 private:
     MeasurementCallbackVector onMeasurement, onCompliance;
@@ -95,7 +134,12 @@ private:
     std::condition_variable_any controlStateChange;
     std::queue<Command> commandQueue;
     VoltageSourcePtr voltageSource;
+    std::shared_ptr<const VoltageSourceConfig> voltageSourceConfig;
+    int64_t nextMeasurementTime;
+    VoltageParameters voltageParameters;
     bool canRun, isRunning;
+    bool commandFailed;
+    std::atomic<uint64_t> executedCommands[NUMBER_OF_COMMAND_STATISTICS], failedCommands[NUMBER_OF_COMMAND_STATISTICS];
 };
 
 } // vsc
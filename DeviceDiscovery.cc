@@ -0,0 +1,199 @@
+/*!
+ * \file DeviceDiscovery.cc
+ * \brief Implementation of DeviceDiscovery and DeviceRegistry classes.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <future>
+#include <memory>
+#include <sstream>
+#include <glob.h>
+
+#include "serialstream.h"
+#include "GpibStream.h"
+#include "log.h"
+#include "DeviceDiscovery.h"
+
+namespace {
+const std::string LOG_HEAD = "DeviceDiscovery";
+const std::string KEITHLEY6487_IDENTIFICATION_PREFIX = "KEITHLEY INSTRUMENTS INC.,MODEL 6487";
+const std::string KEITHLEY237_MODEL_NUMBER_PREFIX = "237";
+
+std::string TrimLine(std::string line)
+{
+    while(!line.empty() && (line.back() == '\r' || line.back() == '\n' || line.back() == ' '))
+        line.erase(line.size() - 1);
+    return line;
+}
+
+unsigned TimeoutInMilliseconds(const vsc::Time& timeout)
+{
+    return static_cast<unsigned>(timeout / (1.0 * vsc::milli * vsc::seconds));
+}
+
+bool ProbeSerialPort(const std::string& port, const vsc::DiscoveryOptions& options, vsc::DiscoveredDevice& device)
+{
+    try {
+        SerialOptions serialOptions;
+        serialOptions.setDevice(port);
+        serialOptions.setBaudrate(options.SerialBaudrate);
+        serialOptions.setTimeout(boost::posix_time::milliseconds(TimeoutInMilliseconds(options.Timeout)));
+        SerialStream stream(serialOptions);
+        stream.exceptions(std::ios::badbit | std::ios::failbit);
+        stream << "*IDN?" << std::endl;
+        std::string reply;
+        std::getline(stream, reply);
+        device.bus = vsc::DiscoveredDevice::Bus::Serial;
+        device.Address = port;
+        device.Identification = TrimLine(reply);
+        return !device.Identification.empty();
+    } catch(std::ios_base::failure&) {
+        return false;
+    }
+}
+
+#ifdef GPIB_SUPPORT
+bool Query(GpibStream& stream, const std::string& command, std::string& reply)
+{
+    try {
+        stream << command << std::flush;
+        std::getline(stream, reply);
+        reply = TrimLine(reply);
+        return !reply.empty();
+    } catch(std::ios_base::failure&) {
+        stream.clear();
+        return false;
+    }
+}
+
+bool ProbeGpibAddress(int board, int address, const vsc::DiscoveryOptions& options, vsc::DiscoveredDevice& device)
+{
+    if(!GpibDevice::IsListenerPresent(board, address))
+        return false;
+    try {
+        GpibStream stream(board, address, TimeoutInMilliseconds(options.Timeout));
+        stream.exceptions(std::ios::badbit | std::ios::failbit);
+        std::string reply;
+        if(!Query(stream, "U0X", reply) && !Query(stream, "*IDN?\n", reply))
+            return false;
+        std::ostringstream ss;
+        ss << "gpib" << board << ":" << address;
+        device.bus = vsc::DiscoveredDevice::Bus::Gpib;
+        device.Address = ss.str();
+        device.Identification = reply;
+        return true;
+    } catch(std::ios_base::failure&) {
+        return false;
+    }
+}
+#endif // GPIB_SUPPORT
+}
+
+namespace vsc {
+
+DeviceRegistry::DeviceVector DeviceRegistry::FindByDriver(const std::string& driver) const
+{
+    DeviceVector result;
+    for(const DiscoveredDevice& device : devices) {
+        if(device.Driver == driver)
+            result.push_back(device);
+    }
+    return result;
+}
+
+const DiscoveredDevice* DeviceRegistry::FindByAddress(const std::string& address) const
+{
+    for(const DiscoveredDevice& device : devices) {
+        if(device.Address == address)
+            return &device;
+    }
+    return nullptr;
+}
+
+DiscoveryOptions::DiscoveryOptions()
+    : SerialPorts(DeviceDiscovery::SerialPortCandidates()), SerialBaudrate(9600), GpibBoards(1, 0),
+      Timeout(0.3 * seconds)
+{
+    for(int address = 1; address <= 30; ++address)
+        GpibAddresses.push_back(address);
+}
+
+std::vector<std::string> DeviceDiscovery::SerialPortCandidates()
+{
+    static const char* patterns[] = { "/dev/ttyUSB*", "/dev/ttyACM*" };
+    std::vector<std::string> ports;
+    for(const char* pattern : patterns) {
+        glob_t result;
+        if(glob(pattern, 0, nullptr, &result) == 0) {
+            for(size_t n = 0; n < result.gl_pathc; ++n)
+                ports.push_back(result.gl_pathv[n]);
+        }
+        globfree(&result);
+    }
+    return ports;
+}
+
+std::string DeviceDiscovery::DriverForIdentification(const std::string& identification)
+{
+    if(identification.find(KEITHLEY6487_IDENTIFICATION_PREFIX) == 0)
+        return "Keithley6487";
+    if(identification.find(KEITHLEY237_MODEL_NUMBER_PREFIX) == 0)
+        return "Keithley237";
+    return "";
+}
+
+DeviceRegistry DeviceDiscovery::Discover(const DiscoveryOptions& options)
+{
+    typedef std::shared_ptr<DiscoveredDevice> DevicePtr;
+    typedef std::pair<DevicePtr, std::future<bool>> Probe;
+    std::vector<Probe> probes;
+
+    for(const std::string& port : options.SerialPorts) {
+        const DevicePtr device(new DiscoveredDevice());
+        probes.push_back(Probe(device, std::async(std::launch::async, [port, &options, device]() {
+            return ProbeSerialPort(port, options, *device);
+        })));
+    }
+#ifdef GPIB_SUPPORT
+    for(int board : options.GpibBoards) {
+        for(int address : options.GpibAddresses) {
+            const DevicePtr device(new DiscoveredDevice());
+            probes.push_back(Probe(device, std::async(std::launch::async, [board, address, &options, device]() {
+                return ProbeGpibAddress(board, address, options, *device);
+            })));
+        }
+    }
+#endif // GPIB_SUPPORT
+
+    DeviceRegistry registry;
+    for(Probe& probe : probes) {
+        if(!probe.second.get())
+            continue;
+        DiscoveredDevice& device = *probe.first;
+        device.Driver = DriverForIdentification(device.Identification);
+        LogInfo(LOG_HEAD) << "Found '" << device.Identification << "' on " << device.Address << ".\n";
+        registry.Add(device);
+    }
+    return registry;
+}
+
+} // vsc
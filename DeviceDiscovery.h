@@ -0,0 +1,115 @@
+/*!
+ * \file DeviceDiscovery.h
+ * \brief Definition of DeviceDiscovery and DeviceRegistry classes.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "units.h"
+
+namespace vsc {
+
+/// An instrument found by DeviceDiscovery.
+struct DiscoveredDevice {
+    /// Bus to which the instrument is connected.
+    enum class Bus { Serial, Gpib };
+
+    Bus bus;
+
+    /// Device path of the serial port or "gpib<board>:<address>" for GPIB instruments.
+    std::string Address;
+
+    /// Identification string reported by the instrument.
+    std::string Identification;
+
+    /// Name of the VoltageSourceFactory driver for the instrument or empty string if the instrument is not supported.
+    std::string Driver;
+};
+
+/*!
+ * \brief Collection of the discovered instruments.
+ */
+class DeviceRegistry {
+public:
+    typedef std::vector<DiscoveredDevice> DeviceVector;
+
+    void Add(const DiscoveredDevice& device) { devices.push_back(device); }
+
+    /// Returns all discovered instruments in the order they were probed.
+    const DeviceVector& Devices() const { return devices; }
+
+    /// Returns the instruments that are supported by the given driver.
+    DeviceVector FindByDriver(const std::string& driver) const;
+
+    /// Returns the instrument connected to the given address or nullptr if there is no such instrument.
+    const DiscoveredDevice* FindByAddress(const std::string& address) const;
+
+private:
+    DeviceVector devices;
+};
+
+/// Where and how DeviceDiscovery should look for the instruments.
+struct DiscoveryOptions {
+    /// Serial ports to probe. By default all USB serial adapters (/dev/ttyUSB*, /dev/ttyACM*) are probed.
+    std::vector<std::string> SerialPorts;
+
+    /// Baudrate of the serial ports.
+    unsigned SerialBaudrate;
+
+    /// Indices of the GPIB boards to probe.
+    std::vector<int> GpibBoards;
+
+    /// Primary addresses to probe on each GPIB board. By default all addresses from 1 to 30 are probed.
+    std::vector<int> GpibAddresses;
+
+    /// Time to wait for the identification reply from each candidate.
+    Time Timeout;
+
+    DiscoveryOptions();
+};
+
+/*!
+ * \brief Finds the instruments connected to the serial ports and to the GPIB bus.
+ *
+ * All candidates are probed in parallel, so the discovery takes about one timeout regardless of the number of empty
+ * ports. SCPI instruments are identified with "*IDN?", Keithley 236/237/238 with the model number query "U0X". GPIB
+ * probing is available only if the program is built with GPIB_SUPPORT.
+ */
+class DeviceDiscovery {
+public:
+    /// Probe all candidates and return the instruments that replied.
+    static DeviceRegistry Discover(const DiscoveryOptions& options = DiscoveryOptions());
+
+    /// Returns the serial ports of the USB serial adapters present in the system.
+    static std::vector<std::string> SerialPortCandidates();
+
+    /// Returns the driver name for the instrument identification string or empty string if it is not supported.
+    static std::string DriverForIdentification(const std::string& identification);
+
+private:
+    DeviceDiscovery() {}
+};
+
+} // vsc
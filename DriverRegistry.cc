@@ -0,0 +1,108 @@
+/*!
+ * \file DriverRegistry.cc
+ * \brief Implementation of DriverRegistry class.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <dlfcn.h>
+#include <dirent.h>
+
+#include "exception.h"
+#include "log.h"
+#include "DriverRegistry.h"
+
+namespace {
+const std::string LOG_HEAD = "DriverRegistry";
+const std::string PLUGIN_PREFIX = "libvsc_";
+const std::string PLUGIN_SUFFIX = ".so";
+}
+
+namespace vsc {
+
+DriverRegistry& DriverRegistry::Singleton()
+{
+    static DriverRegistry registry;
+    return registry;
+}
+
+void DriverRegistry::Register(const DriverInfo& driver)
+{
+    const std::lock_guard<std::recursive_mutex> lock(mutex);
+    if(drivers.count(driver.Name))
+        THROW_VSC_EXCEPTION("Configuration error", "Voltage source driver '" << driver.Name
+                            << "' is already registered.");
+    drivers[driver.Name] = driver;
+}
+
+const DriverInfo& DriverRegistry::Get(const std::string& name, const std::string& pluginDirectory)
+{
+    const std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto iter = drivers.find(name);
+    if(iter != drivers.end())
+        return iter->second;
+
+    if(name.empty() || name.find('/') != std::string::npos)
+        THROW_VSC_EXCEPTION("Configuration error", "Invalid voltage source name '" << name << "'.");
+    const std::string fileName = PluginFileName(pluginDirectory, name);
+    if(!dlopen(fileName.c_str(), RTLD_NOW | RTLD_GLOBAL)) {
+        const char* error = dlerror();
+        LogDebug(LOG_HEAD) << "Plugin '" << fileName << "' is not loaded. " << (error ? error : "") << std::endl;
+        THROW_VSC_EXCEPTION("Configuration error", "Voltage source '" << name << "' not found.");
+    }
+    LogInfo(LOG_HEAD) << "Plugin '" << fileName << "' is loaded.\n";
+
+    iter = drivers.find(name);
+    if(iter == drivers.end())
+        THROW_VSC_EXCEPTION("Configuration error", "Plugin '" << fileName << "' does not register the voltage source '"
+                            << name << "'.");
+    return iter->second;
+}
+
+DriverRegistry::NameSet DriverRegistry::GetNames(const std::string& pluginDirectory) const
+{
+    NameSet names;
+    {
+        const std::lock_guard<std::recursive_mutex> lock(mutex);
+        for(const auto& driver : drivers)
+            names.insert(driver.first);
+    }
+
+    DIR* directory = opendir(pluginDirectory.c_str());
+    if(!directory)
+        return names;
+    while(const dirent* entry = readdir(directory)) {
+        const std::string fileName = entry->d_name;
+        const size_t nameSize = fileName.size() - std::min(fileName.size(), PLUGIN_PREFIX.size() + PLUGIN_SUFFIX.size());
+        if(nameSize && !fileName.compare(0, PLUGIN_PREFIX.size(), PLUGIN_PREFIX)
+                && !fileName.compare(PLUGIN_PREFIX.size() + nameSize, PLUGIN_SUFFIX.size(), PLUGIN_SUFFIX))
+            names.insert(fileName.substr(PLUGIN_PREFIX.size(), nameSize));
+    }
+    closedir(directory);
+    return names;
+}
+
+std::string DriverRegistry::PluginFileName(const std::string& pluginDirectory, const std::string& driverName)
+{
+    return pluginDirectory + "/" + PLUGIN_PREFIX + driverName + PLUGIN_SUFFIX;
+}
+
+} // vsc
@@ -0,0 +1,124 @@
+/*!
+ * \file DriverRegistry.h
+ * \brief Definition of DriverRegistry class.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <functional>
+#include <boost/utility.hpp>
+
+#include "IVoltageSource.h"
+
+class VoltageSourceConfig;
+
+/*!
+ * \brief Register a voltage source driver in DriverRegistry during the program or plugin initialization.
+ * \param name - driver name used in the "Driver" configuration parameter.
+ * \param maker - function that creates the driver from VoltageSourceConfig.
+ * \param capabilities - combination of vsc::DriverCapability flags.
+ * \param ... - names of the configuration parameters used by the driver.
+ */
+#define VSC_REGISTER_DRIVER(name, maker, capabilities, ...) \
+    static const vsc::DriverRegistrar name##DriverRegistrar(#name, maker, capabilities, { __VA_ARGS__ })
+
+namespace vsc {
+
+/// Optional features of the voltage source drivers.
+namespace DriverCapability {
+enum : unsigned { None = 0, MeasurementParameters = 1, DeviceTimestamp = 2, Simulation = 4, Gpib = 8, Serial = 16 };
+}
+
+/// Description of a voltage source driver.
+struct DriverInfo {
+    typedef std::function<IVoltageSource* (const VoltageSourceConfig&)> Maker;
+
+    std::string Name;
+    Maker maker;
+
+    /// Combination of DriverCapability flags.
+    unsigned Capabilities;
+
+    /// Names of the configuration parameters used by the driver.
+    std::vector<std::string> ConfigSchema;
+
+    bool HasCapability(unsigned capability) const { return (Capabilities & capability) == capability; }
+};
+
+/*!
+ * \brief Collection of all available voltage source drivers.
+ *
+ * Drivers compiled into the program register themselves with VSC_REGISTER_DRIVER. Other drivers can be shipped as
+ * shared objects named "libvsc_<driver name>.so" in the plugin directory: such plugin is loaded with dlopen only when
+ * the driver is requested for the first time, and it registers itself in the same way. Plugins use the symbols of the
+ * program, so the program should be linked with -rdynamic.
+ */
+class DriverRegistry : private boost::noncopyable {
+public:
+    typedef std::set<std::string> NameSet;
+
+    static DriverRegistry& Singleton();
+
+    /*!
+     * \brief Register a driver.
+     * \throw vsc::exception if a driver with the same name is already registered.
+     */
+    void Register(const DriverInfo& driver);
+
+    /*!
+     * \brief Returns the driver with the given name, loading its plugin if necessary.
+     * \throw vsc::exception if there is no such driver.
+     */
+    const DriverInfo& Get(const std::string& name, const std::string& pluginDirectory);
+
+    /// Returns names of the registered drivers and of the plugins found in the plugin directory.
+    NameSet GetNames(const std::string& pluginDirectory) const;
+
+private:
+    DriverRegistry() {}
+    static std::string PluginFileName(const std::string& pluginDirectory, const std::string& driverName);
+
+private:
+    mutable std::recursive_mutex mutex;
+    std::map<std::string, DriverInfo> drivers;
+};
+
+/// Registers a driver when constructed. Used by VSC_REGISTER_DRIVER.
+struct DriverRegistrar {
+    DriverRegistrar(const std::string& name, const DriverInfo::Maker& maker, unsigned capabilities,
+                    const std::vector<std::string>& configSchema)
+    {
+        DriverInfo driver;
+        driver.Name = name;
+        driver.maker = maker;
+        driver.Capabilities = capabilities;
+        driver.ConfigSchema = configSchema;
+        DriverRegistry::Singleton().Register(driver);
+    }
+};
+
+} // vsc
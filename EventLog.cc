@@ -0,0 +1,397 @@
+/*!
+ * \file EventLog.cc
+ * \brief Implementation of EventLog and EventLogReader classes.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <sstream>
+#include <limits>
+
+#include "exception.h"
+#include "date_time.h"
+#include "EventLog.h"
+
+namespace {
+const size_t BUFFER_SIZE = 64 * 1024;
+const size_t MAX_STRING_LENGTH = std::numeric_limits<uint16_t>::max();
+
+const vsc::ElectricCurrent CURRENT_FACTOR = 1.0 * vsc::amperes;
+const vsc::ElectricPotential VOLTAGE_FACTOR = 1.0 * vsc::volts;
+const vsc::Time TIME_FACTOR = 1.0 * vsc::seconds;
+
+int64_t WallTimeNow()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+template<typename Value>
+bool Extract(const std::vector<char>& payload, size_t& position, Value& value)
+{
+    if(position + sizeof(Value) > payload.size())
+        return false;
+    std::memcpy(&value, payload.data() + position, sizeof(Value));
+    position += sizeof(Value);
+    return true;
+}
+
+bool ExtractString(const std::vector<char>& payload, size_t& position, std::string& str)
+{
+    uint16_t length;
+    if(!Extract(payload, position, length) || position + length > payload.size())
+        return false;
+    str.assign(payload.data() + position, length);
+    position += length;
+    return true;
+}
+}
+
+namespace vsc {
+namespace events {
+
+const char FILE_MAGIC[8] = { 'V', 'S', 'C', 'E', 'V', 'L', 'O', 'G' };
+const uint32_t FILE_VERSION = 3;
+
+const std::string& SchemaText()
+{
+    static const std::string schema =
+            "1 command command:str\n"
+            "2 reply_latency latency_ns:i64 command:str\n"
+            "3 measurement current_A:f64 voltage_V:f64 timestamp_s:f64 compliance:u8 device_timestamp_s:f64\n"
+            "4 compliance in_compliance:u8\n"
+            "5 error message:str\n";
+    return schema;
+}
+
+std::vector<RecordSchema> ParseSchema(const std::string& schemaText)
+{
+    std::vector<RecordSchema> result;
+    std::istringstream schemaStream(schemaText);
+    std::string line;
+    while(std::getline(schemaStream, line)) {
+        std::istringstream lineStream(line);
+        unsigned type;
+        RecordSchema record;
+        if(!(lineStream >> type >> record.name))
+            continue;
+        record.type = static_cast<EventType>(type);
+        std::string field;
+        while(lineStream >> field) {
+            const size_t separator = field.find(':');
+            if(separator == std::string::npos)
+                THROW_VSC_EXCEPTION("Invalid event log", "Invalid field description '" << field << "'.");
+            FieldSchema fieldSchema;
+            fieldSchema.name = field.substr(0, separator);
+            const std::string typeName = field.substr(separator + 1);
+            if(typeName == "i64") fieldSchema.type = FieldType::Int64;
+            else if(typeName == "f64") fieldSchema.type = FieldType::Float64;
+            else if(typeName == "u8") fieldSchema.type = FieldType::UInt8;
+            else if(typeName == "str") fieldSchema.type = FieldType::String;
+            else
+                THROW_VSC_EXCEPTION("Invalid event log", "Unknown field type '" << typeName << "'.");
+            record.fields.push_back(fieldSchema);
+        }
+        result.push_back(record);
+    }
+    return result;
+}
+
+} // events
+
+EventLog& EventLog::Singleton()
+{
+    static EventLog eventLog;
+    return eventLog;
+}
+
+EventLog::EventLog()
+    : isOpen(false), file(nullptr), startTime(0)
+{
+    buffer.reserve(BUFFER_SIZE);
+}
+
+EventLog::~EventLog()
+{
+    Close();
+}
+
+void EventLog::Open(const std::string& fileName)
+{
+    Close();
+    std::lock_guard<std::mutex> lock(mutex);
+    file = std::fopen(fileName.c_str(), "wb");
+    if(!file)
+        THROW_VSC_EXCEPTION("Open file error", "Unable to open the event log file '" << fileName << "'.");
+    startTime = DateTimeProvider::ElapsedNanoseconds();
+    const int64_t startWallTime = WallTimeNow();
+    const std::string& schema = events::SchemaText();
+    const uint32_t schemaLength = static_cast<uint32_t>(schema.size());
+    buffer.clear();
+    buffer.insert(buffer.end(), events::FILE_MAGIC, events::FILE_MAGIC + sizeof(events::FILE_MAGIC));
+    Append(events::FILE_VERSION);
+    Append(startWallTime);
+    Append(schemaLength);
+    buffer.insert(buffer.end(), schema.begin(), schema.end());
+    isOpen = true;
+}
+
+void EventLog::Close()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if(!file)
+        return;
+    isOpen = false;
+    WriteBuffer();
+    std::fclose(file);
+    file = nullptr;
+}
+
+void EventLog::Flush()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if(!file)
+        return;
+    WriteBuffer();
+    std::fflush(file);
+}
+
+void EventLog::Command(const std::string& command, uint16_t source)
+{
+    if(!IsOpen())
+        return;
+    std::lock_guard<std::mutex> lock(mutex);
+    const size_t header = BeginRecord(events::EventType::Command, source);
+    AppendString(command);
+    EndRecord(header);
+}
+
+void EventLog::ReplyLatency(const std::string& command, int64_t latencyInNanoseconds, uint16_t source)
+{
+    if(!IsOpen())
+        return;
+    std::lock_guard<std::mutex> lock(mutex);
+    const size_t header = BeginRecord(events::EventType::ReplyLatency, source);
+    Append(latencyInNanoseconds);
+    AppendString(command);
+    EndRecord(header);
+}
+
+void EventLog::Measurement(const IVoltageSource::Measurement& measurement, uint16_t source)
+{
+    if(!IsOpen())
+        return;
+    std::lock_guard<std::mutex> lock(mutex);
+    const size_t header = BeginRecord(events::EventType::Measurement, source);
+    AppendMeasurement(measurement);
+    EndRecord(header);
+}
+
+void EventLog::Compliance(bool inCompliance, uint16_t source)
+{
+    if(!IsOpen())
+        return;
+    std::lock_guard<std::mutex> lock(mutex);
+    const size_t header = BeginRecord(events::EventType::Compliance, source);
+    Append(static_cast<uint8_t>(inCompliance));
+    EndRecord(header);
+}
+
+void EventLog::Error(const std::string& message, uint16_t source)
+{
+    if(!IsOpen())
+        return;
+    std::lock_guard<std::mutex> lock(mutex);
+    const size_t header = BeginRecord(events::EventType::Error, source);
+    AppendString(message);
+    EndRecord(header);
+}
+
+size_t EventLog::BeginRecord(events::EventType type, uint16_t source)
+{
+    if(buffer.size() >= BUFFER_SIZE)
+        WriteBuffer();
+    const size_t position = buffer.size();
+    events::RecordHeader header;
+    header.type = static_cast<uint8_t>(type);
+    header.reserved = 0;
+    header.source = source;
+    header.payloadSize = 0;
+    header.time = Now();
+    Append(header);
+    return position;
+}
+
+void EventLog::EndRecord(size_t headerPosition)
+{
+    const uint32_t payloadSize = static_cast<uint32_t>(buffer.size() - headerPosition - sizeof(events::RecordHeader));
+    std::memcpy(buffer.data() + headerPosition + offsetof(events::RecordHeader, payloadSize), &payloadSize,
+                sizeof(payloadSize));
+}
+
+template<typename Value>
+void EventLog::Append(const Value& value)
+{
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(Value));
+}
+
+void EventLog::AppendMeasurement(const IVoltageSource::Measurement& measurement)
+{
+    Append<double>(measurement.Current / CURRENT_FACTOR);
+    Append<double>(measurement.Voltage / VOLTAGE_FACTOR);
+    Append<double>(measurement.Timestamp / TIME_FACTOR);
+    Append(static_cast<uint8_t>(measurement.Compliance));
+    Append<double>(measurement.HasDeviceTimestamp ? static_cast<double>(measurement.DeviceTimestamp / TIME_FACTOR)
+                                                  : std::numeric_limits<double>::quiet_NaN());
+}
+
+void EventLog::AppendString(const std::string& str)
+{
+    const uint16_t length = static_cast<uint16_t>(std::min(str.size(), MAX_STRING_LENGTH));
+    Append(length);
+    buffer.insert(buffer.end(), str.begin(), str.begin() + length);
+}
+
+void EventLog::WriteBuffer()
+{
+    if(file && buffer.size())
+        std::fwrite(buffer.data(), 1, buffer.size(), file);
+    buffer.clear();
+}
+
+int64_t EventLog::Now() const
+{
+    return DateTimeProvider::ElapsedNanoseconds() - startTime;
+}
+
+EventLogReader::EventLogReader(const std::string& fileName)
+    : file(std::fopen(fileName.c_str(), "rb")), startWallTime(0)
+{
+    if(!file)
+        THROW_VSC_EXCEPTION("Read file error", "Unable to open the event log file '" << fileName << "'.");
+    char magic[sizeof(events::FILE_MAGIC)];
+    uint32_t version = 0, schemaLength = 0;
+    if(std::fread(magic, sizeof(magic), 1, file) != 1
+            || std::memcmp(magic, events::FILE_MAGIC, sizeof(magic))
+            || std::fread(&version, sizeof(version), 1, file) != 1
+            || std::fread(&startWallTime, sizeof(startWallTime), 1, file) != 1
+            || std::fread(&schemaLength, sizeof(schemaLength), 1, file) != 1) {
+        std::fclose(file);
+        THROW_VSC_EXCEPTION("Invalid event log", "File '" << fileName << "' is not an event log.");
+    }
+    if(!version || version > events::FILE_VERSION) {
+        std::fclose(file);
+        THROW_VSC_EXCEPTION("Invalid event log", "Event log '" << fileName << "' has unsupported version "
+                            << version << ".");
+    }
+    std::string schemaText(schemaLength, '\0');
+    if(schemaLength && std::fread(&schemaText[0], schemaLength, 1, file) != 1) {
+        std::fclose(file);
+        THROW_VSC_EXCEPTION("Invalid event log", "Event log '" << fileName << "' has a truncated header.");
+    }
+    try {
+        schema = events::ParseSchema(schemaText);
+    } catch(vsc::exception&) {
+        std::fclose(file);
+        throw;
+    }
+}
+
+EventLogReader::~EventLogReader()
+{
+    std::fclose(file);
+}
+
+const events::RecordSchema* EventLogReader::FindSchema(events::EventType type) const
+{
+    for(const events::RecordSchema& recordSchema : schema) {
+        if(recordSchema.type == type)
+            return &recordSchema;
+    }
+    return nullptr;
+}
+
+bool EventLogReader::Next(events::Record& record)
+{
+    if(std::fread(&record.header, sizeof(record.header), 1, file) != 1)
+        return false;
+    record.payload.resize(record.header.payloadSize);
+    if(record.header.payloadSize && std::fread(record.payload.data(), record.header.payloadSize, 1, file) != 1)
+        return false;
+    return true;
+}
+
+std::vector<events::FieldValue> EventLogReader::Decode(const events::Record& record) const
+{
+    std::vector<events::FieldValue> values;
+    const events::RecordSchema* recordSchema = FindSchema(static_cast<events::EventType>(record.header.type));
+    if(!recordSchema)
+        return values;
+    size_t position = 0;
+    for(const events::FieldSchema& field : recordSchema->fields) {
+        events::FieldValue value;
+        value.type = field.type;
+        bool ok = false;
+        if(field.type == events::FieldType::Int64) {
+            ok = Extract(record.payload, position, value.integer);
+        } else if(field.type == events::FieldType::Float64) {
+            ok = Extract(record.payload, position, value.real);
+        } else if(field.type == events::FieldType::UInt8) {
+            uint8_t v = 0;
+            ok = Extract(record.payload, position, v);
+            value.integer = v;
+        } else {
+            ok = ExtractString(record.payload, position, value.text);
+        }
+        if(!ok)
+            THROW_VSC_EXCEPTION("Invalid event log", "Record of type '" << recordSchema->name
+                                << "' has a truncated payload.");
+        values.push_back(value);
+    }
+    return values;
+}
+
+bool EventLogReader::DecodeMeasurement(const events::Record& record, IVoltageSource::Measurement& measurement)
+{
+    const events::EventType type = static_cast<events::EventType>(record.header.type);
+    if(type != events::EventType::Measurement)
+        return false;
+    size_t position = 0;
+    double current, voltage, timestamp;
+    uint8_t compliance;
+    if(!Extract(record.payload, position, current) || !Extract(record.payload, position, voltage)
+            || !Extract(record.payload, position, timestamp) || !Extract(record.payload, position, compliance))
+        return false;
+    measurement = IVoltageSource::Measurement(current * CURRENT_FACTOR, voltage * VOLTAGE_FACTOR,
+                                              timestamp * TIME_FACTOR, compliance != 0);
+    double deviceTimestamp;
+    if(Extract(record.payload, position, deviceTimestamp) && deviceTimestamp == deviceTimestamp) {
+        measurement.DeviceTimestamp = deviceTimestamp * TIME_FACTOR;
+        measurement.HasDeviceTimestamp = true;
+    }
+    return true;
+}
+
+} // vsc
@@ -0,0 +1,208 @@
+/*!
+ * \file EventLog.h
+ * \brief Definition of EventLog and EventLogReader classes.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <boost/utility.hpp>
+
+#include "IVoltageSource.h"
+
+namespace vsc {
+namespace events {
+
+/// Types of the records stored in the event log.
+enum class EventType : uint8_t { Command = 1, ReplyLatency = 2, Measurement = 3, Compliance = 4, Error = 5 };
+
+/// Types of the fields of the event log records.
+enum class FieldType { Int64, Float64, UInt8, String };
+
+/*!
+ * \brief Header of each record in the event log file.
+ *
+ * The header is followed by \a payloadSize bytes of fields, encoded in the order declared in the file schema.
+ * Numbers are stored in the native (little-endian) byte order, strings as a 16-bit length followed by characters.
+ */
+struct RecordHeader {
+    /// Type of the record (EventType).
+    uint8_t type;
+
+    /// Reserved for the future use. Always zero.
+    uint8_t reserved;
+
+    /// Identifier of the voltage source that produced the event.
+    uint16_t source;
+
+    /// Number of the payload bytes that follow the header.
+    uint32_t payloadSize;
+
+    /// Time in nanoseconds since the log was opened.
+    int64_t time;
+};
+
+/// Description of a record field.
+struct FieldSchema {
+    std::string name;
+    FieldType type;
+};
+
+/// Description of a record type.
+struct RecordSchema {
+    EventType type;
+    std::string name;
+    std::vector<FieldSchema> fields;
+};
+
+/// A value of a decoded record field.
+struct FieldValue {
+    FieldType type;
+    int64_t integer;
+    double real;
+    std::string text;
+
+    FieldValue() : type(FieldType::Int64), integer(0), real(0) {}
+};
+
+/// A record read from the event log.
+struct Record {
+    RecordHeader header;
+    std::vector<char> payload;
+};
+
+/// Magic string at the beginning of each event log file.
+extern const char FILE_MAGIC[8];
+
+/// Version of the event log file format.
+extern const uint32_t FILE_VERSION;
+
+/// Returns the schema text stored in the event log header.
+const std::string& SchemaText();
+
+/// Parse the schema text.
+std::vector<RecordSchema> ParseSchema(const std::string& schemaText);
+
+} // events
+
+/*!
+ * \brief Compact binary log of the device transactions.
+ *
+ * Each event is stored as a fixed header and a few raw binary fields, without any text formatting, so every transaction
+ * can be logged at full rate. The file starts with a header that contains a text schema of all record types, which
+ * allows to decode the log offline without knowing the program version that wrote it (see EventLogDecoder).
+ * Nothing is written unless the log is opened.
+ */
+class EventLog : private boost::noncopyable {
+public:
+    static EventLog& Singleton();
+
+    ~EventLog();
+
+    /// Open the log file. Previously opened file is closed.
+    void Open(const std::string& fileName);
+
+    /// Write all buffered records and close the log file.
+    void Close();
+
+    /// Write all buffered records into the file.
+    void Flush();
+
+    /// Indicates if the log is opened.
+    bool IsOpen() const { return isOpen.load(std::memory_order_relaxed); }
+
+    /// Record a command sent to the device.
+    void Command(const std::string& command, uint16_t source = 0);
+
+    /// Record the time between a command sent to the device and its reply received.
+    void ReplyLatency(const std::string& command, int64_t latencyInNanoseconds, uint16_t source = 0);
+
+    /// Record a measurement.
+    void Measurement(const IVoltageSource::Measurement& measurement, uint16_t source = 0);
+
+    /// Record that the device went into compliance or left it. The measurement is recorded separately.
+    void Compliance(bool inCompliance, uint16_t source = 0);
+
+    /// Record an error.
+    void Error(const std::string& message, uint16_t source = 0);
+
+private:
+    EventLog();
+    size_t BeginRecord(events::EventType type, uint16_t source);
+    void EndRecord(size_t headerPosition);
+    template<typename Value>
+    void Append(const Value& value);
+    void AppendString(const std::string& str);
+    void AppendMeasurement(const IVoltageSource::Measurement& measurement);
+    void WriteBuffer();
+    int64_t Now() const;
+
+private:
+    std::mutex mutex;
+    std::atomic<bool> isOpen;
+    std::FILE* file;
+    std::vector<char> buffer;
+    int64_t startTime;
+};
+
+/*!
+ * \brief Reads records from the event log file.
+ */
+class EventLogReader : private boost::noncopyable {
+public:
+    /*!
+     * \brief Open the event log file and read its header.
+     * \throw vsc::exception if file can't be opened or if it is not an event log.
+     */
+    explicit EventLogReader(const std::string& fileName);
+    ~EventLogReader();
+
+    /// Returns the wall-clock time in nanoseconds since the Unix epoch when the log was opened.
+    int64_t StartWallTime() const { return startWallTime; }
+
+    /// Returns the schema of all record types stored in the file.
+    const std::vector<events::RecordSchema>& Schema() const { return schema; }
+
+    /// Returns the schema of the given record type or nullptr if the type is unknown.
+    const events::RecordSchema* FindSchema(events::EventType type) const;
+
+    /// Read the next record. Returns false at the end of file.
+    bool Next(events::Record& record);
+
+    /// Decode record fields according to the file schema.
+    std::vector<events::FieldValue> Decode(const events::Record& record) const;
+
+    /// Decode a measurement record. Returns false for the records of other types.
+    static bool DecodeMeasurement(const events::Record& record, IVoltageSource::Measurement& measurement);
+
+private:
+    std::FILE* file;
+    int64_t startWallTime;
+    std::vector<events::RecordSchema> schema;
+};
+
+} // vsc
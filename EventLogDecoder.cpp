@@ -0,0 +1,174 @@
+/*!
+ * \file EventLogDecoder.cpp
+ * \brief Converts a binary event log into CSV or JSON.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Usage: EventLogDecoder csv|json input_file [output_file]
+ *
+ * CSV output has one row per record. Columns are the record time, the source id, the record type and the union of
+ * all fields declared in the file schema; fields that do not belong to the record type are left empty.
+ * JSON output is an array with one object per record.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+#include "exception.h"
+#include "EventLog.h"
+
+namespace {
+void PrintUsage()
+{
+    std::cerr << "Usage: EventLogDecoder csv|json input_file [output_file]" << std::endl;
+}
+
+std::string EscapeJson(const std::string& str)
+{
+    std::ostringstream ss;
+    for(char c : str) {
+        if(c == '"' || c == '\\')
+            ss << '\\' << c;
+        else if(static_cast<unsigned char>(c) < 0x20)
+            ss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+        else
+            ss << c;
+    }
+    return ss.str();
+}
+
+std::string EscapeCsv(const std::string& str)
+{
+    if(str.find_first_of(",\"\n") == std::string::npos)
+        return str;
+    std::string result = "\"";
+    for(char c : str) {
+        if(c == '"')
+            result += '"';
+        result += c;
+    }
+    return result + "\"";
+}
+
+void PrintValue(std::ostream& s, const vsc::events::FieldValue& value, bool json)
+{
+    if(value.type == vsc::events::FieldType::Float64) {
+        if(value.real == value.real)
+            s << std::setprecision(10) << value.real;
+        else if(json)
+            s << "null";
+    }
+    else if(value.type == vsc::events::FieldType::String)
+        s << (json ? "\"" + EscapeJson(value.text) + "\"" : EscapeCsv(value.text));
+    else
+        s << value.integer;
+}
+
+void WriteCsv(vsc::EventLogReader& reader, std::ostream& output)
+{
+    std::vector<std::string> columns;
+    for(const auto& recordSchema : reader.Schema()) {
+        for(const auto& field : recordSchema.fields) {
+            if(std::find(columns.begin(), columns.end(), field.name) == columns.end())
+                columns.push_back(field.name);
+        }
+    }
+
+    output << "time_ns,source,event";
+    for(const auto& column : columns)
+        output << "," << column;
+    output << "\n";
+
+    vsc::events::Record record;
+    while(reader.Next(record)) {
+        const vsc::events::RecordSchema* recordSchema =
+                reader.FindSchema(static_cast<vsc::events::EventType>(record.header.type));
+        if(!recordSchema)
+            continue;
+        const std::vector<vsc::events::FieldValue> values = reader.Decode(record);
+        output << record.header.time << "," << record.header.source << "," << recordSchema->name;
+        for(const auto& column : columns) {
+            output << ",";
+            for(size_t n = 0; n < recordSchema->fields.size(); ++n) {
+                if(recordSchema->fields[n].name == column)
+                    PrintValue(output, values.at(n), false);
+            }
+        }
+        output << "\n";
+    }
+}
+
+void WriteJson(vsc::EventLogReader& reader, std::ostream& output)
+{
+    output << "{\"start_wall_time_ns\":" << reader.StartWallTime() << ",\"events\":[";
+    vsc::events::Record record;
+    bool first = true;
+    while(reader.Next(record)) {
+        const vsc::events::RecordSchema* recordSchema =
+                reader.FindSchema(static_cast<vsc::events::EventType>(record.header.type));
+        if(!recordSchema)
+            continue;
+        const std::vector<vsc::events::FieldValue> values = reader.Decode(record);
+        output << (first ? "\n" : ",\n") << "{\"time_ns\":" << record.header.time << ",\"source\":"
+               << record.header.source << ",\"event\":\"" << recordSchema->name << "\"";
+        for(size_t n = 0; n < values.size(); ++n) {
+            output << ",\"" << recordSchema->fields[n].name << "\":";
+            PrintValue(output, values[n], true);
+        }
+        output << "}";
+        first = false;
+    }
+    output << "\n]}\n";
+}
+}
+
+int main(int argc, char *argv[])
+{
+    if(argc < 3 || argc > 4) {
+        PrintUsage();
+        return 1;
+    }
+    const std::string format = argv[1];
+    if(format != "csv" && format != "json") {
+        PrintUsage();
+        return 1;
+    }
+
+    try {
+        vsc::EventLogReader reader(argv[2]);
+        std::ofstream outputFile;
+        if(argc == 4) {
+            outputFile.open(argv[3]);
+            if(!outputFile.is_open())
+                THROW_VSC_EXCEPTION("Write file error", "Unable to open the output file '" << argv[3] << "'.");
+        }
+        std::ostream& output = argc == 4 ? outputFile : std::cout;
+        if(format == "csv")
+            WriteCsv(reader, output);
+        else
+            WriteJson(reader, output);
+    } catch(vsc::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,23 @@
+#-------------------------------------------------
+#
+# Offline decoder of the binary event log.
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+TARGET = EventLogDecoder
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+QMAKE_CXXFLAGS = -std=c++11
+
+SOURCES += EventLogDecoder.cpp \
+    date_time.cc \
+    EventLog.cc
+
+HEADERS += EventLog.h \
+    date_time.h \
+    IVoltageSource.h \
+    units.h \
+    exception.h
@@ -0,0 +1,201 @@
+/*!
+ * \file FaultInjection.cc
+ * \brief Implementation of FaultSchedule and FaultInjectingVoltageSource classes.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sstream>
+
+#include "FaultInjection.h"
+#include "exception.h"
+#include "log.h"
+
+namespace vsc {
+
+FaultSchedule::FaultSchedule(const std::string& description, unsigned long long seed)
+    : generator(seed), uniform(0.0, 1.0), operation(0)
+{
+    std::istringstream ss(description);
+    std::string item;
+    while(std::getline(ss, item, ',')) {
+        const size_t separator = item.find_first_of("=@");
+        if(separator == std::string::npos)
+            THROW_VSC_EXCEPTION("Invalid configuration", "Invalid fault schedule item '" << item << "'.");
+        const FaultType type = Parse(item.substr(0, separator));
+        std::istringstream value(item.substr(separator + 1));
+        if(item[separator] == '=') {
+            double probability;
+            if(!(value >> probability) || !value.eof() || probability < 0 || probability > 1)
+                THROW_VSC_EXCEPTION("Invalid configuration", "Invalid fault probability in '" << item << "'.");
+            probabilities[type] = probability;
+        } else {
+            unsigned long long operationNumber;
+            if(!(value >> operationNumber) || !value.eof() || !operationNumber)
+                THROW_VSC_EXCEPTION("Invalid configuration", "Invalid operation number in '" << item << "'.");
+            scripted[operationNumber] = type;
+        }
+    }
+    double totalProbability = 0;
+    for(const auto& probability : probabilities)
+        totalProbability += probability.second;
+    if(totalProbability > 1)
+        THROW_VSC_EXCEPTION("Invalid configuration", "The sum of the fault probabilities in '" << description
+                            << "' is greater than 1.");
+}
+
+FaultType FaultSchedule::Next()
+{
+    ++operation;
+    const auto iter = scripted.find(operation);
+    if(iter != scripted.end())
+        return iter->second;
+    const double random = uniform(generator);
+    double cumulativeProbability = 0;
+    for(const auto& probability : probabilities) {
+        cumulativeProbability += probability.second;
+        if(random < cumulativeProbability)
+            return probability.first;
+    }
+    return FaultType::None;
+}
+
+FaultType FaultSchedule::Parse(const std::string& name)
+{
+    if(name == "spike")
+        return FaultType::LatencySpike;
+    if(name == "timeout")
+        return FaultType::Timeout;
+    if(name == "garbled")
+        return FaultType::GarbledReply;
+    if(name == "dropped")
+        return FaultType::DroppedBytes;
+    if(name == "disconnect")
+        return FaultType::Disconnect;
+    THROW_VSC_EXCEPTION("Invalid configuration", "Unknown fault type '" << name << "'.");
+}
+
+const std::vector<std::string>& FaultInjectingVoltageSource::ConfigSchema()
+{
+    static const std::vector<std::string> schema = {
+        "Faults", "FaultSeed", "FaultLatencySpike", "FaultTimeout", "FaultReconnectTime"
+    };
+    return schema;
+}
+
+FaultInjectingVoltageSource::FaultInjectingVoltageSource(IVoltageSource* _voltageSource,
+                                                         const FaultSchedule& _schedule, const Settings& _settings)
+    : voltageSource(_voltageSource), schedule(_schedule), settings(_settings), disconnectedUntil(0), failureTime(0)
+{
+}
+
+IVoltageSource::Value FaultInjectingVoltageSource::Set(const Value& value)
+{
+    return Execute("Set", [&]() { return voltageSource->Set(value); });
+}
+
+ElectricPotential FaultInjectingVoltageSource::Accuracy(const ElectricPotential& voltage)
+{
+    return voltageSource->Accuracy(voltage);
+}
+
+IVoltageSource::Measurement FaultInjectingVoltageSource::Measure()
+{
+    return Execute("Measure", [&]() { return voltageSource->Measure(); });
+}
+
+void FaultInjectingVoltageSource::Off()
+{
+    Execute("Off", [&]() { voltageSource->Off(); });
+}
+
+void FaultInjectingVoltageSource::SetMeasurementParameters(unsigned numberOfReadingsToAverage,
+                                                           const Time& integrationTime)
+{
+    Execute("SetMeasurementParameters", [&]() {
+        voltageSource->SetMeasurementParameters(numberOfReadingsToAverage, integrationTime);
+    });
+}
+
+template<typename Operation>
+auto FaultInjectingVoltageSource::Execute(const char* name, const Operation& operation) -> decltype(operation())
+{
+    if(DateTimeProvider::ElapsedNanoseconds() < disconnectedUntil)
+        Fail(name, "device is disconnected");
+
+    const FaultType fault = schedule.Next();
+    if(fault == FaultType::LatencySpike)
+        Sleep(settings.LatencySpike);
+    else if(fault == FaultType::Timeout) {
+        Sleep(settings.Timeout);
+        Fail(name, "reply timeout");
+    } else if(fault == FaultType::Disconnect) {
+        disconnectedUntil = DateTimeProvider::ElapsedNanoseconds()
+                + static_cast<int64_t>(settings.ReconnectTime / (nano * seconds));
+        Fail(name, "device is disconnected");
+    } else if(fault == FaultType::GarbledReply) {
+        operation();
+        Fail(name, "garbled reply");
+    } else if(fault == FaultType::DroppedBytes) {
+        operation();
+        Sleep(settings.Timeout);
+        Fail(name, "incomplete reply");
+    }
+
+    // The recovery is reported after the result of the operation is constructed, so the guard also works for the
+    // operations that return nothing.
+    struct RecoveryGuard {
+        FaultInjectingVoltageSource& source;
+        bool failed;
+        ~RecoveryGuard() {
+            if(!failed)
+                source.Recovered();
+        }
+    } guard{*this, false};
+    try {
+        return operation();
+    } catch(...) {
+        guard.failed = true;
+        if(!failureTime)
+            failureTime = DateTimeProvider::ElapsedNanoseconds();
+        throw;
+    }
+}
+
+void FaultInjectingVoltageSource::Recovered()
+{
+    if(!failureTime)
+        return;
+    const int64_t latency = DateTimeProvider::ElapsedNanoseconds() - failureTime;
+    failureTime = 0;
+    recoveryLatency.Add(latency);
+    LogInfo("FaultInjection") << "Recovered after " << latency * nano * seconds << ", worst recovery latency "
+                              << recoveryLatency.Maximum() << ".\n";
+}
+
+void FaultInjectingVoltageSource::Fail(const char* name, const std::string& reason)
+{
+    if(!failureTime)
+        failureTime = DateTimeProvider::ElapsedNanoseconds();
+    THROW_VSC_EXCEPTION("Communication error", "Injected failure in " << name << " on operation "
+                        << schedule.Operations() << ": " << reason << ".");
+}
+
+} // vsc
@@ -0,0 +1,140 @@
+/*!
+ * \file FaultInjection.h
+ * \brief Definition of FaultSchedule and FaultInjectingVoltageSource classes.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "IVoltageSource.h"
+#include "date_time.h"
+
+namespace vsc {
+
+/// Types of the failures that can be injected.
+enum class FaultType { None, LatencySpike, Timeout, GarbledReply, DroppedBytes, Disconnect };
+
+/*!
+ * \brief Decides which failure, if any, happens on each device operation.
+ *
+ * The schedule is described by a comma-separated list without spaces. An item "<fault>=<probability>" injects the
+ * fault at random with the given probability per operation, and an item "<fault>@<operation>" injects it exactly on
+ * the given operation (counted from 1). Scripted faults take precedence over the random ones. Fault names are
+ * "spike", "timeout", "garbled", "dropped" and "disconnect". Example: "spike=0.01,timeout=0.001,disconnect@500".
+ *
+ * The random faults are mutually exclusive: a single random number is drawn per operation and the fault is chosen
+ * from the cumulative probabilities, so each fault happens with exactly its configured probability. Therefore the sum
+ * of the probabilities should not exceed 1.
+ */
+class FaultSchedule {
+public:
+    /*!
+     * \brief Parse the schedule description.
+     * \throw vsc::exception if the description is invalid.
+     */
+    FaultSchedule(const std::string& description, unsigned long long seed);
+
+    /// Returns the fault for the next operation.
+    FaultType Next();
+
+    /// Returns the number of operations since the schedule was created.
+    unsigned long long Operations() const { return operation; }
+
+private:
+    static FaultType Parse(const std::string& name);
+
+private:
+    std::map<FaultType, double> probabilities;
+    std::map<unsigned long long, FaultType> scripted;
+    std::mt19937_64 generator;
+    std::uniform_real_distribution<double> uniform;
+    unsigned long long operation;
+};
+
+/*!
+ * \brief Voltage source decorator that injects failures into the operations of another voltage source.
+ *
+ * A latency spike delays the operation. A timeout waits for the timeout interval and fails without reaching the
+ * device. A garbled reply or dropped bytes let the operation reach the device and then fail as the drivers do when
+ * they can't parse a reply or do not receive its end. A disconnect fails all operations until the reconnect time has
+ * passed. The time from the first failure to the next successful operation is collected as the recovery latency.
+ */
+class FaultInjectingVoltageSource : public IVoltageSource {
+public:
+    /// Durations of the injected failures.
+    struct Settings {
+        Time LatencySpike;
+        Time Timeout;
+        Time ReconnectTime;
+
+        Settings() : LatencySpike(1.0 * seconds), Timeout(3.0 * seconds), ReconnectTime(10.0 * seconds) {}
+    };
+
+public:
+    FaultInjectingVoltageSource(IVoltageSource* voltageSource, const FaultSchedule& schedule,
+                                const Settings& settings);
+
+    /// Names of the voltage source configuration parameters that set up the fault injection.
+    static const std::vector<std::string>& ConfigSchema();
+
+    /// \copydoc IVoltageSource::Set
+    virtual Value Set(const Value& value);
+
+    /// \copydoc IVoltageSource::Accuracy
+    virtual ElectricPotential Accuracy(const ElectricPotential& voltage);
+
+    /// \copydoc IVoltageSource::Measure
+    virtual Measurement Measure();
+
+    /// \copydoc IVoltageSource::Off
+    virtual void Off();
+
+    /// \copydoc IVoltageSource::SetMeasurementParameters
+    virtual void SetMeasurementParameters(unsigned numberOfReadingsToAverage, const Time& integrationTime);
+
+    /// \copydoc IVoltageSource::GetClock
+    virtual Clock& GetClock() { return voltageSource->GetClock(); }
+
+    /// Returns the statistics of the time in nanoseconds between a failure and the next successful operation.
+    const OvershootStatistics& RecoveryLatency() const { return recoveryLatency; }
+
+private:
+    template<typename Operation>
+    auto Execute(const char* name, const Operation& operation) -> decltype(operation());
+
+    void Fail(const char* name, const std::string& reason);
+    void Recovered();
+
+private:
+    std::unique_ptr<IVoltageSource> voltageSource;
+    FaultSchedule schedule;
+    Settings settings;
+    int64_t disconnectedUntil, failureTime;
+    OvershootStatistics recoveryLatency;
+};
+
+} // vsc
@@ -0,0 +1,115 @@
+/*!
+ * \file FileWatcher.cc
+ * \brief Implementation of FileWatcher class.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+#include "exception.h"
+#include "log.h"
+#include "FileWatcher.h"
+
+namespace {
+const std::string LOG_HEAD = "FileWatcher";
+
+/// Interval without changes after which the change is reported.
+const int SETTLE_INTERVAL_IN_MILLISECONDS = 100;
+}
+
+namespace vsc {
+
+FileWatcher::FileWatcher(const std::string& fileName, const OnChangeCallback& _onChange)
+    : onChange(_onChange)
+{
+    const size_t separatorPosition = fileName.rfind('/');
+    directory = separatorPosition == std::string::npos ? "." : fileName.substr(0, separatorPosition + 1);
+    name = separatorPosition == std::string::npos ? fileName : fileName.substr(separatorPosition + 1);
+
+    inotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if(inotifyDescriptor < 0)
+        THROW_VSC_EXCEPTION("File watcher error", "Unable to initialize inotify. " << std::strerror(errno));
+    if(inotify_add_watch(inotifyDescriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        const int error = errno;
+        close(inotifyDescriptor);
+        THROW_VSC_EXCEPTION("File watcher error", "Unable to watch '" << fileName << "'. " << std::strerror(error));
+    }
+    if(pipe(stopPipe) != 0) {
+        const int error = errno;
+        close(inotifyDescriptor);
+        THROW_VSC_EXCEPTION("File watcher error", "Unable to create a pipe. " << std::strerror(error));
+    }
+    thread = std::thread(&FileWatcher::Run, this);
+}
+
+FileWatcher::~FileWatcher()
+{
+    const char stop = 0;
+    if(write(stopPipe[1], &stop, 1) != 1)
+        LogError(LOG_HEAD) << "Unable to stop the watcher thread.\n";
+    thread.join();
+    close(stopPipe[0]);
+    close(stopPipe[1]);
+    close(inotifyDescriptor);
+}
+
+void FileWatcher::Run()
+{
+    while(WaitForChange()) {
+        try {
+            onChange();
+        } catch(vsc::exception& e) {
+            LogError(LOG_HEAD) << e.what() << std::endl;
+        }
+    }
+}
+
+bool FileWatcher::WaitForChange()
+{
+    alignas(inotify_event) char buffer[4096];
+    bool changed = false;
+    for(;;) {
+        pollfd descriptors[2] = { { stopPipe[0], POLLIN, 0 }, { inotifyDescriptor, POLLIN, 0 } };
+        const int result = poll(descriptors, 2, changed ? SETTLE_INTERVAL_IN_MILLISECONDS : -1);
+        if(result < 0 && errno == EINTR)
+            continue;
+        if(result < 0 || descriptors[0].revents)
+            return false;
+        if(!result)
+            return true;
+
+        ssize_t length;
+        while((length = read(inotifyDescriptor, buffer, sizeof(buffer))) > 0) {
+            for(const char* ptr = buffer; ptr < buffer + length;) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(ptr);
+                if(event->len && name == event->name)
+                    changed = true;
+                ptr += sizeof(inotify_event) + event->len;
+            }
+        }
+    }
+}
+
+} // vsc
@@ -0,0 +1,65 @@
+/*!
+ * \file FileWatcher.h
+ * \brief Definition of FileWatcher class.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <string>
+#include <thread>
+#include <functional>
+#include <boost/utility.hpp>
+
+namespace vsc {
+/*!
+ * \brief Calls a callback each time the watched file is rewritten.
+ *
+ * The file is watched with inotify on its directory, so the changes made by editors that replace the file with a new
+ * one are also detected. Several changes that happen within a short interval are reported once. The callback is called
+ * from the watcher thread; a vsc::exception thrown by the callback is reported to the error log.
+ */
+class FileWatcher : private boost::noncopyable {
+public:
+    typedef std::function<void ()> OnChangeCallback;
+
+    /*!
+     * \brief Start watching the file.
+     * \throw vsc::exception if inotify watch can't be created.
+     */
+    FileWatcher(const std::string& fileName, const OnChangeCallback& onChange);
+
+    /// Stop watching and wait for the watcher thread.
+    ~FileWatcher();
+
+private:
+    void Run();
+    bool WaitForChange();
+
+private:
+    std::string directory, name;
+    OnChangeCallback onChange;
+    int inotifyDescriptor;
+    int stopPipe[2];
+    std::thread thread;
+};
+
+} // vsc
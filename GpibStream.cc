@@ -25,13 +25,23 @@
 
 #include <map>
 #include <sstream>
+#include <cstdio>
 #include <gpib/ib.h>
 
 #include "GpibStream.h"
 
+static const unsigned DEFAULT_ADDRESS_TIMEOUT_IN_MILLISECONDS = 3000;
+
 GpibDevice::GpibDevice(const std::string& deviceName, bool _goLocalOnDestruction)
-    : goLocalOnDestruction(_goLocalOnDestruction)
+    : goLocalOnDestruction(_goLocalOnDestruction), closeOnDestruction(false)
 {
+    int boardIndex, primaryAddress;
+    char end;
+    if(std::sscanf(deviceName.c_str(), "gpib%d:%d%c", &boardIndex, &primaryAddress, &end) == 2) {
+        Open(boardIndex, primaryAddress, DEFAULT_ADDRESS_TIMEOUT_IN_MILLISECONDS);
+        return;
+    }
+
     device_handle = ibfind(deviceName.c_str());
     if(device_handle < 0)
         throw std::ios_base::failure(GetReportMessage());
@@ -41,10 +51,47 @@ GpibDevice::GpibDevice(const std::string& deviceName, bool _goLocalOnDestruction
         throw std::ios_base::failure(GetReportMessage());
 }
 
+GpibDevice::GpibDevice(int boardIndex, int primaryAddress, unsigned timeoutInMilliseconds)
+    : goLocalOnDestruction(false), closeOnDestruction(false)
+{
+    Open(boardIndex, primaryAddress, timeoutInMilliseconds);
+}
+
 GpibDevice::~GpibDevice()
 {
     if(goLocalOnDestruction)
         ibloc(device_handle);
+    if(closeOnDestruction)
+        ibonl(device_handle, 0);
+}
+
+void GpibDevice::Open(int boardIndex, int primaryAddress, unsigned timeoutInMilliseconds)
+{
+    static const unsigned timeouts[] = { 1, 3, 10, 30, 100, 300, 1000, 3000, 10000, 30000, 100000, 300000, 1000000 };
+    static const size_t numberOfTimeouts = sizeof(timeouts) / sizeof(timeouts[0]);
+    size_t n = 0;
+    while(n < numberOfTimeouts - 1 && timeouts[n] < timeoutInMilliseconds)
+        ++n;
+    const int timeoutCode = T1ms + static_cast<int>(n);
+
+    device_handle = ibdev(boardIndex, primaryAddress, 0, timeoutCode, 1, BIN | '\n');
+    if(device_handle < 0)
+        throw std::ios_base::failure(GetReportMessage());
+    closeOnDestruction = true;
+
+    ibclr(device_handle);
+    if(ibsta & ERR) {
+        const std::string message = GetReportMessage();
+        ibonl(device_handle, 0);
+        throw std::ios_base::failure(message);
+    }
+}
+
+bool GpibDevice::IsListenerPresent(int boardIndex, int primaryAddress)
+{
+    short found = 0;
+    ibln(boardIndex, primaryAddress, NO_SAD, &found);
+    return !(ibsta & ERR) && found;
 }
 
 std::streamsize GpibDevice::read(char_type *s, std::streamsize n)
@@ -40,6 +40,9 @@ public:
     /// Returns a repornt message that includes the GPIB status message and the GPIB error message.
     static std::string GetReportMessage();
 
+    /// Check if there is a device that listens on the given address of the GPIB board.
+    static bool IsListenerPresent(int boardIndex, int primaryAddress);
+
 public:
     /*!
      * \brief The character type of the GPIB device.
@@ -56,13 +59,22 @@ public:
 public:
     /*!
      * \brief Create GPIB Device for the givend device name.
-     * \param deviceName - name of the device as it declared in gpib.conf.
+     * \param deviceName - name of the device as it declared in gpib.conf or its bus address in the form
+     *                     "gpib<board index>:<primary address>", e.g. "gpib0:20".
      * \param goLocalOnDestruction - indicates if the LOC signal should be send to the GPIB bus during the destruction
      *                               of the GpibDevice object. The LOC signal switches all devices connected to the GPIB
      *                               bus to the local mode.
      */
     explicit GpibDevice(const std::string& deviceName, bool goLocalOnDestruction);
 
+    /*!
+     * \brief Create GPIB Device for the given bus address.
+     * \param boardIndex - index of the GPIB interface board.
+     * \param primaryAddress - primary GPIB address of the device.
+     * \param timeoutInMilliseconds - I/O timeout. It is rounded up to the nearest timeout supported by the driver.
+     */
+    GpibDevice(int boardIndex, int primaryAddress, unsigned timeoutInMilliseconds);
+
     /*!
      * \brief Destructor
      * Destroy GpibDevice object and return devices in a local mode.
@@ -91,6 +103,12 @@ private:
 
     /// Indicates if the LOC signal should be send to the GPIB bus during the destruction of the GpibDevice object.
     bool goLocalOnDestruction;
+
+    /// Indicates if the device handle was opened by address and should be closed during the destruction.
+    bool closeOnDestruction;
+
+private:
+    void Open(int boardIndex, int primaryAddress, unsigned timeoutInMilliseconds);
 };
 
 /*!
@@ -23,19 +23,29 @@
  */
 
 #include <QMetaType>
+#include <QGuiApplication>
+#include <QScreen>
 #include "GuiController.h"
+#include "date_time.h"
+#include "log.h"
+
+namespace {
+const double DEFAULT_FRAME_RATE = 60;
+const int64_t STATISTICS_INTERVAL = 10000000000;
+}
 
 Q_DECLARE_METATYPE(vsc::exception)
 
 GuiController::GuiController() :
     controllerThread(std::bind(&vsc::Controller::operator(), &controller)),
-    mainWindow(controller)
+    mainWindow(controller), statisticsStartTime(vsc::DateTimeProvider::ElapsedNanoseconds())
 {
     using namespace std::placeholders;
     controller.AddOnConnectSuccessfulCallback(std::bind(&GuiController::_ConnectSuccessful, this));
     controller.AddOnConnectFailedCallback(std::bind(&GuiController::_ConnectFailed, this, _1));
     controller.AddOnDisconnectSuccessfulCallback(std::bind(&GuiController::_DisconnectSuccessful, this));
     controller.AddOnDisconnectFailedCallback(std::bind(&GuiController::_DisconnectFailed, this, _1));
+    controller.AddOnMeasurementCallback(std::bind(&vsc::MeasurementBridge::Push, &measurementBridge, _1));
 
     qRegisterMetaType<vsc::exception>();
 
@@ -44,6 +54,12 @@ GuiController::GuiController() :
     QObject::connect(this, SIGNAL(DisconnectSuccessful()), &mainWindow, SLOT(onDisconnectSuccessful()));
     QObject::connect(this, SIGNAL(DisconnectFailed(vsc::exception)), &mainWindow, SLOT(onDisconnectFailed(vsc::exception)));
 
+    const QScreen* screen = QGuiApplication::primaryScreen();
+    const double frameRate = screen && screen->refreshRate() > 0 ? screen->refreshRate() : DEFAULT_FRAME_RATE;
+    frameTimer.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&frameTimer, SIGNAL(timeout()), this, SLOT(onFrame()));
+    frameTimer.start(static_cast<int>(1000 / frameRate));
+
     mainWindow.show();
 }
 
@@ -72,3 +88,20 @@ void GuiController::_DisconnectFailed(const vsc::exception& e)
 {
     emit DisconnectFailed(e);
 }
+
+void GuiController::onFrame()
+{
+    if(measurementBridge.Pull(frameMeasurements))
+        mainWindow.onMeasurements(frameMeasurements);
+
+    const int64_t now = vsc::DateTimeProvider::ElapsedNanoseconds();
+    if(now - statisticsStartTime < STATISTICS_INTERVAL)
+        return;
+    statisticsStartTime = now;
+    const vsc::MeasurementBridge::Statistics statistics = measurementBridge.TakeStatistics();
+    if(statistics.Frames)
+        vsc::LogDebug("GuiController") << "Merged " << statistics.Samples << " measurements in "
+                                       << statistics.Frames << " frames: " << statistics.MeanSamplesPerFrame()
+                                       << " per frame on average, " << statistics.MaxSamplesPerFrame
+                                       << " at most.\n";
+}
@@ -25,8 +25,11 @@
 #pragma once
 
 #include <QObject>
+#include <QTimer>
 #include <thread>
+#include <vector>
 #include "MainWindow.h"
+#include "MeasurementBridge.h"
 
 class GuiController : public QObject
 {
@@ -35,6 +38,7 @@ public:
     explicit GuiController();
     virtual ~GuiController();
     MainWindow& getMainWindow() { return mainWindow; }
+    vsc::Controller& getController() { return controller; }
     
 signals:
     void ConnectSuccessful();
@@ -42,6 +46,9 @@ signals:
     void DisconnectSuccessful();
     void DisconnectFailed(const vsc::exception& e);
 
+private slots:
+    void onFrame();
+
 private:
     void _ConnectSuccessful();
     void _ConnectFailed(const vsc::exception& e);
@@ -52,4 +59,8 @@ private:
     vsc::Controller controller;
     std::thread controllerThread;
     MainWindow mainWindow;
+    vsc::MeasurementBridge measurementBridge;
+    QTimer frameTimer;
+    std::vector<vsc::IVoltageSource::Measurement> frameMeasurements;
+    int64_t statisticsStartTime;
 };
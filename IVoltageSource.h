@@ -24,6 +24,7 @@
 #pragma once
 
 #include "units.h"
+#include "date_time.h"
 
 namespace vsc {
 
@@ -42,20 +43,33 @@ public:
         /// Voltage in Volts.
         ElectricPotential Voltage;
 
-        /// Timestamp when measurement was done.
+        /// Timestamp when measurement was done on the steady clock (see DateTimeProvider::ElapsedTime).
         Time Timestamp;
 
         /// Indicates if device is in compliance mode.
         bool Compliance;
 
+        /// Timestamp reported by the device itself. Valid only if HasDeviceTimestamp is true.
+        Time DeviceTimestamp;
+
+        /// Indicates if the device reported its own timestamp.
+        bool HasDeviceTimestamp;
+
         /// Default constructor.
         Measurement() : Current(0.0 * vsc::amperes), Voltage(0.0 * vsc::volts), Timestamp(0.0 * vsc::seconds),
-            Compliance(false) {}
+            Compliance(false), DeviceTimestamp(0.0 * vsc::seconds), HasDeviceTimestamp(false) {}
 
         /// Constructor.
         Measurement(const ElectricCurrent& current, const ElectricPotential& voltage, const Time& timestamp,
                     bool compliance)
-            : Current(current), Voltage(voltage), Timestamp(timestamp), Compliance(compliance) {}
+            : Current(current), Voltage(voltage), Timestamp(timestamp), Compliance(compliance),
+              DeviceTimestamp(0.0 * vsc::seconds), HasDeviceTimestamp(false) {}
+
+        /// Constructor for a measurement that has a timestamp reported by the device.
+        Measurement(const ElectricCurrent& current, const ElectricPotential& voltage, const Time& timestamp,
+                    bool compliance, const Time& deviceTimestamp)
+            : Current(current), Voltage(voltage), Timestamp(timestamp), Compliance(compliance),
+              DeviceTimestamp(deviceTimestamp), HasDeviceTimestamp(true) {}
     };
 
     /*!
@@ -108,24 +122,72 @@ public:
      */
     virtual Measurement Measure() = 0;
 
+    /*!
+     * \brief Perform a series of measurements of voltage and current.
+     * \param n - number of measurements.
+     * \param out - array of at least \a n elements where the measurement results are stored.
+     *
+     * The default implementation calls Measure \a n times. Voltage sources that can store a series of readings in the
+     * device buffer override it to read the whole series in one transaction. If the device does not report when each
+     * reading of the buffer was taken, the timestamps are approximated by SpreadTimestamps, i.e. the readings are
+     * assumed to be evenly spaced over the time of the acquisition.
+     */
+    virtual void MeasureBatch(size_t n, Measurement* out)
+    {
+        for(size_t k = 0; k < n; ++k)
+            out[k] = Measure();
+    }
+
     /// Turn the voltage off.
     virtual void Off() = 0;
 
+    /*!
+     * \brief Change the measurement parameters of the connected device without resetting it.
+     * \param numberOfReadingsToAverage - the amount of filtering for each measurement.
+     * \param integrationTime - the A/D hardware integration time during each measure phase.
+     *
+     * Voltage sources that have no such parameters ignore the call.
+     */
+    virtual void SetMeasurementParameters(unsigned /*numberOfReadingsToAverage*/, const Time& /*integrationTime*/) {}
+
+    /*!
+     * \brief Returns the clock on which the waits between the operations should be scheduled.
+     *
+     * Real devices use the steady clock. A simulated voltage source can return a virtual clock.
+     */
+    virtual Clock& GetClock() { return Clock::Steady(); }
+
     /// IHighVoltageSource virtual destructor
     virtual ~IVoltageSource() {}
-};
 
-}
+protected:
+    /*!
+     * \brief Spread the timestamps of a series of readings evenly over the time of its acquisition.
+     * \param n - number of readings.
+     * \param out - readings of the series.
+     * \param start - time when the acquisition was started.
+     * \param end - time when the last reading was taken.
+     *
+     * The reading k gets the time start + (end - start) * (k + 1) / n, so the last reading has the time \a end.
+     */
+    static void SpreadTimestamps(size_t n, Measurement* out, const Time& start, const Time& end)
+    {
+        for(size_t k = 0; k < n; ++k)
+            out[k].Timestamp = start + (end - start) * (double(k + 1) / n);
+    }
+};
 
-inline std::ostream& operator << (std::ostream& s, const vsc::IVoltageSource::Measurement& m)
+inline std::ostream& operator << (std::ostream& s, const IVoltageSource::Measurement& m)
 {
     s << "Voltage = " << m.Voltage << ", Current = " << m.Current << ", In compliance = "
       << std::boolalpha << m.Compliance;
     return s;
 }
 
-inline std::ostream& operator << (std::ostream& s, const vsc::IVoltageSource::Value& v)
+inline std::ostream& operator << (std::ostream& s, const IVoltageSource::Value& v)
 {
     s << "Voltage = " << v.Voltage << ", Compliance = " << v.Compliance;
     return s;
 }
+
+}
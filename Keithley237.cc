@@ -23,8 +23,17 @@
 
 #ifdef GPIB_SUPPORT
 
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <sstream>
+
 #include "Keithley237.h"
+#include "log.h"
 #include "date_time.h"
+#include "EventLog.h"
+#include "ConfigParameters.h"
+#include "DriverRegistry.h"
 
 using namespace vsc::Keithley237Internals;
 using namespace vsc::Keithley237Internals::Commands;
@@ -33,7 +42,57 @@ const vsc::ElectricCurrent vsc::Keithley237::MAX_COMPLIANCE = 0.01 * vsc::ampere
 const vsc::ElectricPotential vsc::Keithley237::ACCURACY = 0.1 * vsc::volts;
 
 
+namespace {
+/// Connection and instrument state left open by a destroyed Keithley237 object.
+typedef std::map<std::string, boost::shared_ptr<GpibStream>> SessionMap;
+
+std::mutex& SessionMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+SessionMap& Sessions()
+{
+    static SessionMap sessions;
+    return sessions;
+}
+
+const std::string LOG_HEAD = "Keithley237";
+
+/// Size of the sweep buffer of the Keithley.
+const size_t MAX_SWEEP_POINTS = 1000;
+}
+
 vsc::Keithley237::Keithley237(const Configuration& configuration)
+    : deviceName(configuration.GetDeviceName()), reuseSession(configuration.ReuseSession()),
+      filterMode(configuration.GetFilterMode()), integrationTimeMode(configuration.GetIntegrationTimeMode()),
+      eventSource(configuration.GetEventSource()), isOperating(false), biasVoltage(0.0 * vsc::volts),
+      commandLatencies("Keithley237"), lastCommandLatencies(nullptr)
+{
+    if(reuseSession && AcquireSession()) {
+        if(VerifySessionState()) {
+            // The machine status word does not report the filter and integration time, and they could be changed on
+            // the front panel or in the configuration since the session was released, so they are always sent again.
+            SendAndCheck(CmdSetFilter()(filterMode));
+            SendAndCheck(CmdSetIntegrationTime()(integrationTimeMode));
+            LogDebug(LOG_HEAD) << "Reusing the open session with '" << deviceName << "'.\n";
+            return;
+        }
+        LogInfo(LOG_HEAD) << "Keithley state on '" << deviceName << "' is unexpected. Restoring the defaults.\n";
+        gpibStream.reset();
+    }
+    Initialize(configuration);
+}
+
+vsc::Keithley237::~Keithley237()
+{
+    Off();
+    if(reuseSession)
+        ReleaseSession();
+}
+
+void vsc::Keithley237::Initialize(const Configuration& configuration)
 {
     try {
         gpibStream = boost::shared_ptr<GpibStream>(new GpibStream(configuration.GetDeviceName(),
@@ -53,9 +112,38 @@ vsc::Keithley237::Keithley237(const Configuration& configuration)
     }
 }
 
-vsc::Keithley237::~Keithley237()
+bool vsc::Keithley237::AcquireSession()
 {
-    Off();
+    const std::lock_guard<std::mutex> lock(SessionMutex());
+    const SessionMap::iterator iter = Sessions().find(deviceName);
+    if(iter == Sessions().end())
+        return false;
+    gpibStream = iter->second;
+    Sessions().erase(iter);
+    return true;
+}
+
+void vsc::Keithley237::ReleaseSession()
+{
+    const std::lock_guard<std::mutex> lock(SessionMutex());
+    Sessions()[deviceName] = gpibStream;
+}
+
+bool vsc::Keithley237::VerifySessionState()
+{
+    try {
+        Send(CmdSendStatus()(SendMachineStatusWord));
+        const MachineStatus status = Read<MachineStatus>();
+        return status.outputDataFormat.items == (MachineStatus::OutputDataFormat::SourceValue
+                                                 | MachineStatus::OutputDataFormat::MeasureValue)
+                && status.outputDataFormat.format == MachineStatus::OutputDataFormat::ASCII_Prefix_NoSuffix
+                && status.outputDataFormat.lines == MachineStatus::OutputDataFormat::OneLineFromDCBuffer;
+    } catch(vsc::exception&) {
+        return false;
+    } catch(std::ios_base::failure&) {
+        gpibStream->clear();
+        return false;
+    }
 }
 
 void vsc::Keithley237::Prepare()
@@ -89,6 +177,8 @@ vsc::IVoltageSource::Value vsc::Keithley237::Set(const Value& value)
                             << ". After execution of all required commands Keithley is still not in the Operate Mode.");
     Send(CmdSendStatus()(SendComplianceValue));
     ComplianceValue compliance = Read<ComplianceValue>();
+    isOperating = true;
+    biasVoltage = value.Voltage;
     IVoltageSource::Measurement measurement = Measure();
 
     return Value(measurement.Voltage, compliance.CurrentCompliance);
@@ -105,18 +195,73 @@ vsc::IVoltageSource::Measurement vsc::Keithley237::Measure()
     return IVoltageSource::Measurement(m.Current, m.Voltage, DateTimeProvider::ElapsedTime(), m.Compliance);
 }
 
+void vsc::Keithley237::MeasureBatch(size_t n, IVoltageSource::Measurement* out)
+{
+    if(!isOperating) {
+        IVoltageSource::MeasureBatch(n, out);
+        return;
+    }
+    for(size_t first = 0; first < n; first += MAX_SWEEP_POINTS) {
+        const size_t numberOfReadings = std::min(n - first, MAX_SWEEP_POINTS);
+        try {
+            SendAndCheck(CmdSetSourceAndFunction()(SourceVoltageMode, SweepFunction));
+            SendAndCheck(CmdCreateFixedLevelSweep()(biasVoltage, VoltageRanges.GetLastMode(), 0, numberOfReadings));
+            SendAndCheck(CmdSetOutputDataFormat()(MachineStatus::OutputDataFormat::SourceValue |
+                                                  MachineStatus::OutputDataFormat::MeasureValue,
+                                                  MachineStatus::OutputDataFormat::ASCII_Prefix_NoSuffix,
+                                                  MachineStatus::OutputDataFormat::AllLinesFromSweepBuffer));
+            const Time startTime = DateTimeProvider::ElapsedTime();
+            SendAndCheck(CmdImmediateBusTrigger()());
+            ReadSweep(numberOfReadings, out + first, startTime);
+        } catch(vsc::exception&) {
+            RestoreDcFunction();
+            throw;
+        }
+        RestoreDcFunction();
+    }
+}
+
 void vsc::Keithley237::Off()
 {
     SendAndCheck(CmdSetInstrumentMode()(MachineStatus::StandbyMode));
+    isOperating = false;
+}
+
+void vsc::Keithley237::SetMeasurementParameters(unsigned numberOfReadingsToAverage, const Time& integrationTime)
+{
+    const unsigned newFilterMode = Configuration::FilterModes.FindMode(numberOfReadingsToAverage);
+    const unsigned newIntegrationTimeMode = Configuration::IntegrationTimeModes.FindMode(integrationTime);
+    if(newFilterMode != filterMode) {
+        SendAndCheck(CmdSetFilter()(newFilterMode));
+        filterMode = newFilterMode;
+    }
+    if(newIntegrationTimeMode != integrationTimeMode) {
+        SendAndCheck(CmdSetIntegrationTime()(newIntegrationTimeMode));
+        integrationTimeMode = newIntegrationTimeMode;
+    }
+}
+
+/// Returns the command code without arguments. Status requests are distinguished by the requested status.
+static std::string LatencyKey(const std::string& command)
+{
+    const size_t codeLength = command.size() > 1 && command[0] == 'U' ? 2 : 1;
+    return command.substr(0, codeLength);
 }
 
 void vsc::Keithley237::Send(const std::string& command, bool execute)
 {
+    const CommandLatencies& latencies = commandLatencies.Get(LatencyKey(command));
+    const ScopedLatency writeLatency(latencies.Write);
+    const TraceSpan span("Keithley237 write", command);
     try {
+        EventLog::Singleton().Command(command, eventSource);
         (*gpibStream) << command;
         if(execute)
             (*gpibStream) << CmdExecute()();
         gpibStream->flush();
+        lastCommand = command;
+        lastCommandLatencies = &latencies;
+        lastCommandTime = std::chrono::steady_clock::now();
     } catch(std::ios_base::failure& e) {
         THROW_VSC_EXCEPTION("Unable to send a command to the Keithley. Command = '" << command << "'. " << std::endl
                             << e.what() << std::endl << GpibDevice::GetReportMessage());
@@ -143,13 +288,50 @@ std::string vsc::Keithley237::ReadString()
 {
     try {
         std::string str;
-        (*gpibStream) >> str;
+        {
+            const ScopedLatency readLatency(lastCommandLatencies->Read);
+            const TraceSpan span("Keithley237 read", lastCommand);
+            (*gpibStream) >> str;
+        }
+        const int64_t latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - lastCommandTime).count();
+        EventLog::Singleton().ReplyLatency(lastCommand, latency, eventSource);
+        lastCommandLatencies->Reply.Record(latency);
         return str;
     } catch(std::ios_base::failure& e) {
         THROW_VSC_EXCEPTION("Unable to read a data from the Keithley. " << std::endl << e.what());
     }
 }
 
+void vsc::Keithley237::ReadSweep(size_t numberOfReadings, IVoltageSource::Measurement* out, const Time& startTime)
+{
+    const std::string str = ReadString();
+    const Time readTime = DateTimeProvider::ElapsedTime();
+    const ScopedLatency parseLatency(lastCommandLatencies->Parse);
+    std::istringstream s_stream(str);
+    for(size_t n = 0; n < numberOfReadings; ++n) {
+        char separator = ',';
+        if(n)
+            s_stream >> separator;
+        Keithley237Internals::Measurement m;
+        s_stream >> m;
+        if(!s_stream || separator != ',')
+            THROW_VSC_EXCEPTION("Unable to parse the sweep buffer read from the Keithley: '" << str << "'.");
+        out[n] = IVoltageSource::Measurement(m.Current, m.Voltage, readTime, m.Compliance);
+    }
+    SpreadTimestamps(numberOfReadings, out, startTime, readTime);
+}
+
+void vsc::Keithley237::RestoreDcFunction()
+{
+    SendAndCheck(CmdSetOutputDataFormat()(MachineStatus::OutputDataFormat::SourceValue |
+                                          MachineStatus::OutputDataFormat::MeasureValue,
+                                          MachineStatus::OutputDataFormat::ASCII_Prefix_NoSuffix,
+                                          MachineStatus::OutputDataFormat::OneLineFromDCBuffer));
+    SendAndCheck(CmdSetSourceAndFunction()(SourceVoltageMode, DCFunction));
+    SendAndCheck(CmdImmediateBusTrigger()());
+}
+
 static Range<unsigned>::ValueRangeMap CreateFilterModes()
 {
     typedef Range<unsigned>::ValueRangeMap Map;
@@ -175,9 +357,22 @@ const Range<vsc::Time, unsigned, double> vsc::Keithley237::Configuration::Integr
 (CreateIntegrationTimeModes(), 1e-6 * vsc::seconds, "Integration Time", "interval");
 
 vsc::Keithley237::Configuration::Configuration(const std::string& _deviceName, bool _goLocalOnDestruction,
-        unsigned numberOfReadingsToAverage, vsc::Time integrationTime)
+        unsigned numberOfReadingsToAverage, vsc::Time integrationTime, bool _reuseSession, uint16_t _eventSource)
     : deviceName(_deviceName), goLocalOnDestruction(_goLocalOnDestruction),
       filterMode(FilterModes.FindMode(numberOfReadingsToAverage)),
-      integrationTimeMode(IntegrationTimeModes.FindMode(integrationTime)) {}
+      integrationTimeMode(IntegrationTimeModes.FindMode(integrationTime)), reuseSession(_reuseSession),
+      eventSource(_eventSource) {}
+
+static vsc::IVoltageSource* Keithley237Maker(const VoltageSourceConfig& config)
+{
+    const vsc::Keithley237::Configuration keithleyConfig(config.Device(), config.SetToLocalModeOnExit(),
+            config.NumberOfReadingsToAverage(), config.IntegrationTime(),
+            config.ExtraParameter<bool>("ReuseSession", true), config.EventSource());
+    return new vsc::Keithley237(keithleyConfig);
+}
+
+VSC_REGISTER_DRIVER(Keithley237, &Keithley237Maker,
+                    vsc::DriverCapability::MeasurementParameters | vsc::DriverCapability::Gpib,
+                    "Device", "SetToLocalModeOnExit", "NumberOfReadingsToAverage", "IntegrationTime", "ReuseSession");
 
 #endif  // GPIB_SUPPORT
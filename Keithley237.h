@@ -23,9 +23,12 @@
 
 #pragma once
 
+#include <chrono>
 #include "IVoltageSource.h"
 #include "GpibStream.h"
 #include "Keithley237Internals.h"
+#include "LatencyHistogram.h"
+#include "Trace.h"
 
 namespace vsc {
 /*!
@@ -60,12 +63,18 @@ public:
     /*!
      * \brief Keithley237 constructor
      * \param configuration - all configuration parameters that are required to initialize the Keithley.
+     *
+     * If the configuration allows to reuse the session and the previous Keithley237 object connected to the same
+     * device left its session open, the open connection is taken over and the instrument state is verified with a
+     * single machine status query. Only if the state does not match, the Keithley is restored to the factory defaults
+     * and configured from scratch.
      */
     Keithley237(const Configuration& configuration);
 
     /*!
      * \brief Keithley237 destructor.
-     * It returns Keithley to the default conditions and switches it to the local mode.
+     * It switches Keithley to the standby mode. If the session is not reused, the connection is closed and the
+     * Keithley is switched to the local mode.
      */
     virtual ~Keithley237();
 
@@ -78,10 +87,35 @@ public:
     /// \copydoc IVoltageSource::Measure
     virtual IVoltageSource::Measurement Measure();
 
+    /*!
+     * \brief Run a fixed level sweep at the current bias voltage and read the sweep buffer in one transaction.
+     * \copydetails IVoltageSource::MeasureBatch
+     *
+     * The sweep buffer has no timestamps, so the readings are spread evenly between the trigger and the time when the
+     * buffer was read. If the Keithley is not in the operate mode, the readings are taken one by one.
+     */
+    virtual void MeasureBatch(size_t n, IVoltageSource::Measurement* out);
+
     /// \copydoc IVoltageSource::Off
     virtual void Off();
 
+    /// \copydoc IVoltageSource::SetMeasurementParameters
+    /// \throw vsc::exception when there is no fiter mode or integraation time mode found for the given parameters.
+    virtual void SetMeasurementParameters(unsigned numberOfReadingsToAverage, const Time& integrationTime);
+
 private:
+    /// Open the connection and restore the Keithley to the factory defaults and the given configuration.
+    void Initialize(const Configuration& configuration);
+
+    /// Take over the session left open for the device. Returns false if there is no such session.
+    bool AcquireSession();
+
+    /// Leave the session open for the next Keithley237 object connected to the same device.
+    void ReleaseSession();
+
+    /// Check with one status query that the Keithley is responsive and has the expected output format.
+    bool VerifySessionState();
+
     /*!
      * \brief Prepare Keithley to receive remote commands.
      *
@@ -110,6 +144,12 @@ private:
      */
     std::string ReadString();
 
+    /// Read the given number of readings from the sweep buffer of the sweep triggered at \a startTime.
+    void ReadSweep(size_t numberOfReadings, IVoltageSource::Measurement* out, const Time& startTime);
+
+    /// Return the Keithley to the dc function with a single reading per output.
+    void RestoreDcFunction();
+
     /*!
      * \brief Read a quantity from the Keithley.
      * \return readed quantity
@@ -117,6 +157,7 @@ private:
     template<typename Result>
     Result Read() {
         std::string s = ReadString();
+        const ScopedLatency parseLatency(lastCommandLatencies->Parse);
         std::stringstream s_stream;
         s_stream << s;
         Result r;
@@ -127,6 +168,30 @@ private:
 private:
     /// The handle of an opened GPIB device.
     boost::shared_ptr<GpibStream> gpibStream;
+
+    /// The name of the device to which Keithley is connected.
+    std::string deviceName;
+
+    /// Indicates if the session should be left open on destruction.
+    bool reuseSession;
+
+    /// The filter and integration time modes currently set on the Keithley.
+    unsigned filterMode, integrationTimeMode;
+
+    /// The source id under which the commands are recorded into the event log.
+    uint16_t eventSource;
+
+    /// Indicates if the Keithley is in the operate mode and the bias voltage set on it.
+    bool isOperating;
+    ElectricPotential biasVoltage;
+
+    /// The latency histograms of the commands sent to the Keithley.
+    CommandLatencyCache commandLatencies;
+
+    /// The last command sent to the Keithley, its latency histograms and the time when it was sent.
+    std::string lastCommand;
+    const CommandLatencies* lastCommandLatencies;
+    std::chrono::steady_clock::time_point lastCommandTime;
 };
 
 /*!
@@ -150,10 +215,14 @@ public:
      *                               to the GPIB bus to the local mode.
      * \param numberOfReadingsToAverage - the amount of filtering for each measurement.
      * \param integrationTime - the A/D hardware integration time during each measure phase in seconds.
+     * \param reuseSession - indicates if the connection should be kept open after the Keithley237 object is destroyed
+     *                       and reused by the next Keithley237 object connected to the same device.
+     * \param eventSource - the source id under which the commands are recorded into the event log.
      */
     explicit Configuration(const std::string& deviceName, bool goLocalOnDestruction = true,
                            unsigned numberOfReadingsToAverage = FilterModes.GetFirstValue(),
-                           Time integrationTime = IntegrationTimeModes.GetFirstValue());
+                           Time integrationTime = IntegrationTimeModes.GetFirstValue(), bool reuseSession = true,
+                           uint16_t eventSource = 0);
 
     /// Returns the name of the device to which Keithely is connected.
     const std::string& GetDeviceName() const {
@@ -190,6 +259,16 @@ public:
         return integrationTimeMode;
     }
 
+    /// Indicates if the connection should be reused between the Keithley237 objects.
+    bool ReuseSession() const {
+        return reuseSession;
+    }
+
+    /// Returns the source id under which the commands are recorded into the event log.
+    uint16_t GetEventSource() const {
+        return eventSource;
+    }
+
 private:
     /// The name of the device to which Keithley is connected.
     std::string deviceName;
@@ -202,6 +281,12 @@ private:
 
     /// The integration time mode id.
     unsigned integrationTimeMode;
+
+    /// Indicates if the connection should be reused between the Keithley237 objects.
+    bool reuseSession;
+
+    /// The source id under which the commands are recorded into the event log.
+    uint16_t eventSource;
 };
 
 }
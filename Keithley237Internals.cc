@@ -42,6 +42,7 @@ const Command< boost::mpl::vector<SelfTestCommand> > CmdSelfTests("J");
 const Command< boost::mpl::vector<ElectricCurrent, unsigned> > CmdSetCompliance("L");
 const Command< boost::mpl::vector<MachineStatus::Operate> > CmdSetInstrumentMode("N");
 const Command< boost::mpl::vector<unsigned> > CmdSetFilter("P");
+const Command< boost::mpl::vector<ElectricPotential, unsigned, unsigned, unsigned> > CmdCreateFixedLevelSweep("Q0,");
 const Command< boost::mpl::vector<unsigned> > CmdSetIntegrationTime("S");
 const Command< boost::mpl::vector<StatusCommand> > CmdSendStatus("U");
 const Command< boost::mpl::vector<> > CmdExecute("X");
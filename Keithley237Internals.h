@@ -125,7 +125,7 @@ public:
     template<unsigned N, typename T = unsigned>
     class _Creator {};
 
-    BOOST_PP_REPEAT_FROM_TO(0, BOOST_PP_INC(3), KEITHLEY237_DEFINE_CREATOR, () )
+    BOOST_PP_REPEAT_FROM_TO(0, BOOST_PP_INC(4), KEITHLEY237_DEFINE_CREATOR, () )
 
     /// Type definition for the appropriate _Creator specialization.
     typedef _Creator< boost::mpl::size<ParameterList>::value > Creator;
@@ -579,6 +579,15 @@ extern const Command< boost::mpl::vector<MachineStatus::Operate> > CmdSetInstrum
  */
 extern const Command< boost::mpl::vector<unsigned> > CmdSetFilter;
 
+/*!
+ * \brief Command Q0 - Create Fixed Level Sweep.
+ *
+ * Purpose: To create a sweep that takes the given number of measurements at the constant source level.
+ *
+ * Parameters: level (V or A), range, delay in milliseconds (0..65000), count (1..1000).
+ */
+extern const Command< boost::mpl::vector<ElectricPotential, unsigned, unsigned, unsigned> > CmdCreateFixedLevelSweep;
+
 /*!
  * \brief Command S - Itegration Time.
  *
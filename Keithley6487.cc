@@ -22,18 +22,27 @@
  */
 
 
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
 #include "Keithley6487.h"
 #include "exception.h"
 #include "date_time.h"
+#include "ConfigParameters.h"
+#include "DriverRegistry.h"
 
 static const unsigned DEFAULT_TIMEOUT = 3;
 static const unsigned OPERATION_IS_COMPLETE_INDICATOR = 1;
 static const unsigned MAX_VOLTAGE_RANGE = 500; // V
 static const std::string MAX_CURRENT_LIMIT = "2.5e-3"; // A
 static const std::string IDENTIFICATION_STRING_PREFIX = "KEITHLEY INSTRUMENTS INC.,MODEL 6487";
+static const size_t MAX_TRACE_POINTS = 3000;
+static const vsc::Time TRACE_POLL_INTERVAL = 0.01 * vsc::seconds;
 
 static const vsc::ElectricPotential VOLTAGE_FACTOR = 1.0 * vsc::volts;
 static const vsc::ElectricCurrent CURRENT_FACTOR = 1.0 * vsc::amperes;
+static const vsc::Time TIME_FACTOR = 1.0 * vsc::seconds;
 
 const double vsc::Keithley6487::MAX_VOLTAGE = 500;
 const vsc::ElectricPotential vsc::Keithley6487::ACCURACY = 0.1 * vsc::volts;
@@ -41,7 +50,9 @@ const vsc::ElectricPotential vsc::Keithley6487::ACCURACY = 0.1 * vsc::volts;
 
 vsc::Keithley6487::Keithley6487(const std::string& deviceName, unsigned baudrate,
                                 SerialOptions::FlowControl flowControl, SerialOptions::Parity parity,
-                                unsigned char characterSize)
+                                unsigned char characterSize, bool _useDeviceTimestamp, uint16_t _eventSource)
+    : useDeviceTimestamp(_useDeviceTimestamp), eventSource(_eventSource), commandLatencies("Keithley6487"),
+      lastCommandLatencies(nullptr)
 {
     SerialOptions options;
     options.setDevice(deviceName);
@@ -62,7 +73,11 @@ vsc::Keithley6487::Keithley6487(const std::string& deviceName, unsigned baudrate
             THROW_VSC_EXCEPTION("Connection error", "Device connected to '" << deviceName << "' is not supported."
                                 " Device identified it self as '" << identificationString << "'.");
         Send("FUNC 'CURR'");
-        Send("FORM:ELEM READ,VSO");
+        if(useDeviceTimestamp) {
+            Send("SYST:TIME:RES");
+            Send("FORM:ELEM READ,TIME,VSO");
+        } else
+            Send("FORM:ELEM READ,VSO");
     } catch(std::ios_base::failure&) {
         THROW_VSC_EXCEPTION("Connection error", "Unable to connect to the Keithley on '" << deviceName << "'.");
     }
@@ -106,7 +121,47 @@ vsc::IVoltageSource::Measurement vsc::Keithley6487::Measure()
 {
     Send("READ?");
     const Measurement m = Read<Measurement>();
-    return IVoltageSource::Measurement(m.Current, m.Voltage, DateTimeProvider::ElapsedTime(), m.Compliance);
+    const Time timestamp = DateTimeProvider::ElapsedTime();
+    if(m.HasDeviceTimestamp)
+        return IVoltageSource::Measurement(m.Current, m.Voltage, timestamp, m.Compliance, m.DeviceTimestamp);
+    return IVoltageSource::Measurement(m.Current, m.Voltage, timestamp, m.Compliance);
+}
+
+void vsc::Keithley6487::MeasureBatch(size_t n, IVoltageSource::Measurement* out)
+{
+    try {
+        try {
+            for(size_t first = 0; first < n; first += MAX_TRACE_POINTS) {
+                const size_t numberOfReadings = std::min(n - first, MAX_TRACE_POINTS);
+                Send("TRAC:CLE");
+                Send("TRAC:POIN", numberOfReadings);
+                Send("TRIG:COUN", numberOfReadings);
+                Send("TRAC:FEED:CONT NEXT");
+                const Time startTime = DateTimeProvider::ElapsedTime();
+                Send("INIT");
+                WaitForTrace(numberOfReadings);
+                const Time endTime = DateTimeProvider::ElapsedTime();
+                Send("TRAC:DATA?");
+                ReadTrace(numberOfReadings, out + first, startTime, endTime);
+            }
+        } catch(...) {
+            // The acquisition can be still running, so it is aborted before the trigger count is restored.
+            Send("ABOR");
+            RestoreSingleReading();
+            throw;
+        }
+        RestoreSingleReading();
+    } catch(TimeoutException&) {
+        THROW_VSC_EXCEPTION("Connection error", "Unable to connect to the Keithley to read the trace buffer.");
+    } catch(std::ios_base::failure&) {
+        THROW_VSC_EXCEPTION("Connection error", "Unable to connect to the Keithley to read the trace buffer.");
+    }
+}
+
+void vsc::Keithley6487::RestoreSingleReading()
+{
+    Send("TRAC:FEED:CONT NEV");
+    Send("TRIG:COUN 1");
 }
 
 void vsc::Keithley6487::Off()
@@ -119,7 +174,15 @@ void vsc::Keithley6487::Off()
 std::string vsc::Keithley6487::ReadString()
 {
     std::string s;
-    std::getline(*serialStream, s);
+    {
+        const ScopedLatency readLatency(lastCommandLatencies->Read);
+        const TraceSpan span("Keithley6487 read", lastCommand);
+        std::getline(*serialStream, s);
+    }
+    const int64_t latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - lastCommandTime).count();
+    EventLog::Singleton().ReplyLatency(lastCommand, latency, eventSource);
+    lastCommandLatencies->Reply.Record(latency);
     return s;
 }
 
@@ -130,7 +193,59 @@ bool vsc::Keithley6487::LastOperationIsCompleted()
     return operationStatus == OPERATION_IS_COMPLETE_INDICATOR;
 }
 
-std::istream& operator >>(std::istream& s, vsc::Keithley6487::Measurement& m)
+void vsc::Keithley6487::WaitForTrace(size_t numberOfReadings)
+{
+    size_t numberOfStoredReadings = 0;
+    auto lastProgressTime = std::chrono::steady_clock::now();
+    for(;;) {
+        Send("TRAC:POIN:ACT?");
+        const size_t n = Read<size_t>();
+        if(n >= numberOfReadings)
+            return;
+        const auto now = std::chrono::steady_clock::now();
+        if(n != numberOfStoredReadings) {
+            numberOfStoredReadings = n;
+            lastProgressTime = now;
+        } else if(now - lastProgressTime > std::chrono::seconds(DEFAULT_TIMEOUT))
+            THROW_VSC_EXCEPTION("Error on device", "Keithley stopped filling the trace buffer after "
+                                << numberOfStoredReadings << " of " << numberOfReadings << " readings.");
+        Sleep(TRACE_POLL_INTERVAL);
+    }
+}
+
+void vsc::Keithley6487::ReadTrace(size_t numberOfReadings, IVoltageSource::Measurement* out, const Time& startTime,
+                                  const Time& endTime)
+{
+    const std::string s = ReadString();
+    const ScopedLatency parseLatency(lastCommandLatencies->Parse);
+    std::istringstream s_stream(s);
+    std::vector<double> deviceTimes(numberOfReadings, 0);
+    for(size_t n = 0; n < numberOfReadings; ++n) {
+        char c = ',';
+        double current, voltage;
+        if(n)
+            s_stream >> c;
+        s_stream >> current >> c;
+        if(useDeviceTimestamp)
+            s_stream >> deviceTimes[n] >> c;
+        s_stream >> voltage;
+        if(!s_stream || c != ',')
+            THROW_VSC_EXCEPTION("Connection error", "Keithley trace buffer has an incorrect format.");
+        out[n] = IVoltageSource::Measurement(current * CURRENT_FACTOR, voltage * VOLTAGE_FACTOR, endTime, false);
+    }
+    if(!useDeviceTimestamp) {
+        SpreadTimestamps(numberOfReadings, out, startTime, endTime);
+        return;
+    }
+    for(size_t n = 0; n < numberOfReadings; ++n) {
+        const Time deviceTime = deviceTimes[n] * TIME_FACTOR;
+        out[n] = IVoltageSource::Measurement(out[n].Current, out[n].Voltage,
+                                             endTime - (deviceTimes.back() * TIME_FACTOR - deviceTime),
+                                             out[n].Compliance, deviceTime);
+    }
+}
+
+std::istream& vsc::operator >>(std::istream& s, vsc::Keithley6487::Measurement& m)
 {
     char c;
     double current;
@@ -139,9 +254,25 @@ std::istream& operator >>(std::istream& s, vsc::Keithley6487::Measurement& m)
     s >> c;
     if(c != ',')
         THROW_VSC_EXCEPTION("Connection error", "Keithley replay has an incorrect format.");
-    double voltage;
-    s >> voltage;
-    m.Voltage = voltage * VOLTAGE_FACTOR;
+    double value;
+    s >> value;
+    m.HasDeviceTimestamp = s.peek() == ',';
+    if(m.HasDeviceTimestamp) {
+        m.DeviceTimestamp = value * TIME_FACTOR;
+        s >> c >> value;
+    }
+    m.Voltage = value * VOLTAGE_FACTOR;
     m.Compliance = false;
     return s;
 }
+
+static vsc::IVoltageSource* Keithley6487Maker(const VoltageSourceConfig& config)
+{
+    return new vsc::Keithley6487(config.Device(), config.ExtraParameter<unsigned>("Baudrate", 9600),
+                                 SerialOptions::noflow, SerialOptions::noparity, 8,
+                                 config.ExtraParameter<bool>("UseDeviceTimestamp", false), config.EventSource());
+}
+
+VSC_REGISTER_DRIVER(Keithley6487, &Keithley6487Maker,
+                    vsc::DriverCapability::DeviceTimestamp | vsc::DriverCapability::Serial,
+                    "Device", "Baudrate", "UseDeviceTimestamp");
@@ -25,8 +25,12 @@
 
 #include <string>
 #include <memory>
+#include <chrono>
 #include "IVoltageSource.h"
 #include "serialstream.h"
+#include "EventLog.h"
+#include "LatencyHistogram.h"
+#include "Trace.h"
 
 namespace vsc {
 /*!
@@ -53,12 +57,18 @@ public:
         /// Indicates if device is in compliance mode.
         bool Compliance;
 
+        /// Time in seconds since the device timer was reset. Valid only if HasDeviceTimestamp is true.
+        Time DeviceTimestamp;
+
+        /// Indicates if the device reply contained a timestamp.
+        bool HasDeviceTimestamp;
+
         /// Default constructor.
-        Measurement() : Compliance(false) {}
+        Measurement() : Compliance(false), HasDeviceTimestamp(false) {}
 
         /// Constructor.
         Measurement(ElectricCurrent current, ElectricPotential voltage, bool compliance)
-            : Current(current), Voltage(voltage), Compliance(compliance) {}
+            : Current(current), Voltage(voltage), Compliance(compliance), HasDeviceTimestamp(false) {}
     };
 
 public:
@@ -71,11 +81,13 @@ public:
      * \param flowControl - RS232 flow control. Keithley 6487 supports two modes: no control or software flow control
      * \param parity - RS232 parity check
      * \param characterSize - size of the character (can be 7 or 8 bit).
+     * \param useDeviceTimestamp - request the Keithley to add its own timestamp to each reading.
+     * \param eventSource - the source id under which the commands are recorded into the event log.
      */
     Keithley6487(const std::string& deviceName, unsigned baudrate = 9600,
                  SerialOptions::FlowControl flowControl = SerialOptions::noflow,
                  SerialOptions::Parity parity = SerialOptions::noparity,
-                 unsigned char characterSize = 8);
+                 unsigned char characterSize = 8, bool useDeviceTimestamp = false, uint16_t eventSource = 0);
 
     /*!
      * \brief Keithley6487 destructor.
@@ -92,6 +104,17 @@ public:
     /// \copydoc IHighVoltageSource::Measure
     virtual IVoltageSource::Measurement Measure();
 
+    /*!
+     * \brief Take \a n readings into the trace buffer of the Keithley and read them in one transaction.
+     * \copydetails IVoltageSource::MeasureBatch
+     *
+     * If the device timestamps are enabled, they are reported as the device timestamps of the readings. Note that the
+     * trace buffer timestamps are relative to the first reading of each buffer. They are also used to place the
+     * measurement timestamps back from the time when the buffer was filled; otherwise the readings are spread evenly
+     * between the trigger and the time when the buffer was filled.
+     */
+    virtual void MeasureBatch(size_t n, IVoltageSource::Measurement* out);
+
     /// \copydoc IHighVoltageSource::Off
     virtual void Off();
 
@@ -101,7 +124,14 @@ private:
      * \param command - a command string to send
      */
     inline void Send(const std::string& command) {
+        const CommandLatencies& latencies = commandLatencies.Get(command);
+        const ScopedLatency writeLatency(latencies.Write);
+        const TraceSpan span("Keithley6487 write", command);
+        EventLog::Singleton().Command(command, eventSource);
         (*serialStream) << command << std::endl;
+        lastCommand = command;
+        lastCommandLatencies = &latencies;
+        lastCommandTime = std::chrono::steady_clock::now();
     }
 
     /*!
@@ -111,7 +141,18 @@ private:
      */
     template<typename Argument>
     void Send(const std::string& command, const Argument& argument) {
+        const CommandLatencies& latencies = commandLatencies.Get(command);
+        const ScopedLatency writeLatency(latencies.Write);
+        const TraceSpan span("Keithley6487 write", command);
+        if(EventLog::Singleton().IsOpen()) {
+            std::ostringstream ss;
+            ss << command << " " << argument;
+            EventLog::Singleton().Command(ss.str(), eventSource);
+        }
         (*serialStream) << command << " " << argument << std::endl;
+        lastCommand = command;
+        lastCommandLatencies = &latencies;
+        lastCommandTime = std::chrono::steady_clock::now();
     }
 
     /*!
@@ -121,6 +162,7 @@ private:
     template<typename Result>
     Result Read() {
         std::string s = ReadString();
+        const ScopedLatency parseLatency(lastCommandLatencies->Parse);
         std::stringstream s_stream;
         s_stream << s;
         Result r;
@@ -140,11 +182,43 @@ private:
      */
     bool LastOperationIsCompleted();
 
+    /*!
+     * \brief Wait until the trace buffer has the given number of readings.
+     * \throw vsc::exception if the number of readings in the buffer does not grow during the timeout.
+     */
+    void WaitForTrace(size_t numberOfReadings);
+
+    /// Read the given number of readings from the trace buffer filled between \a startTime and \a endTime.
+    void ReadTrace(size_t numberOfReadings, IVoltageSource::Measurement* out, const Time& startTime,
+                   const Time& endTime);
+
+    /// Return the Keithley to a single reading per trigger with the trace buffer feed disabled.
+    void RestoreSingleReading();
+
 private:
     /// A pointer to the object that provides stream access to the serial port.
     boost::shared_ptr<SerialStream> serialStream;
+
+    /// Indicates if the Keithley adds its own timestamp to each reading.
+    bool useDeviceTimestamp;
+
+    /// The source id under which the commands are recorded into the event log.
+    uint16_t eventSource;
+
+    /// The latency histograms of the commands sent to the Keithley.
+    CommandLatencyCache commandLatencies;
+
+    /// The last command sent to the Keithley, its latency histograms and the time when it was sent.
+    std::string lastCommand;
+    const CommandLatencies* lastCommandLatencies;
+    std::chrono::steady_clock::time_point lastCommandTime;
 };
 
-}
+/*!
+ * \brief Read Keithley6487::Measurement from an input stream.
+ *
+ * The expected format is "current,voltage" or "current,timestamp,voltage" when the device timestamps are enabled.
+ */
+std::istream& operator >>(std::istream& s, Keithley6487::Measurement& m);
 
-std::istream& operator >>(std::istream& s, vsc::Keithley6487::Measurement& m);
+}
@@ -0,0 +1,170 @@
+/*!
+ * \file LatencyHistogram.cc
+ * \brief Implementation of LatencyHistogram and LatencyRegistry classes.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+#include "LatencyHistogram.h"
+
+namespace vsc {
+
+const unsigned LatencyHistogram::SUB_BUCKET_BITS;
+const uint64_t LatencyHistogram::SUB_BUCKETS;
+const uint64_t LatencyHistogram::MAX_LATENCY;
+const size_t LatencyHistogram::NUMBER_OF_BUCKETS;
+
+LatencyHistogram::LatencyHistogram()
+{
+    Reset();
+}
+
+size_t LatencyHistogram::BucketIndex(uint64_t latency)
+{
+    if(latency < SUB_BUCKETS)
+        return static_cast<size_t>(latency);
+    const unsigned mostSignificantBit = 63 - __builtin_clzll(latency);
+    const unsigned shift = mostSignificantBit - SUB_BUCKET_BITS;
+    return static_cast<size_t>(shift * SUB_BUCKETS + (latency >> shift));
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(size_t index)
+{
+    if(index < 2 * SUB_BUCKETS)
+        return index;
+    const unsigned shift = static_cast<unsigned>(index / SUB_BUCKETS - 1);
+    const uint64_t mantissa = index - shift * SUB_BUCKETS;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(int64_t latency)
+{
+    const uint64_t value = latency < 0 ? 0 : std::min(static_cast<uint64_t>(latency), MAX_LATENCY);
+    counts[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(value, std::memory_order_relaxed);
+    int64_t previousMax = max.load(std::memory_order_relaxed);
+    while(static_cast<int64_t>(value) > previousMax
+          && !max.compare_exchange_weak(previousMax, static_cast<int64_t>(value), std::memory_order_relaxed)) {}
+}
+
+LatencySummary LatencyHistogram::Summary() const
+{
+    // The buckets are read one by one while the other threads may record, so the total is taken from the buckets.
+    uint64_t snapshot[NUMBER_OF_BUCKETS];
+    uint64_t numberOfRecords = 0;
+    for(size_t n = 0; n < NUMBER_OF_BUCKETS; ++n) {
+        snapshot[n] = counts[n].load(std::memory_order_relaxed);
+        numberOfRecords += snapshot[n];
+    }
+
+    LatencySummary summary;
+    summary.Count = numberOfRecords;
+    summary.Max = max.load(std::memory_order_relaxed);
+    const uint64_t recordedCount = count.load(std::memory_order_relaxed);
+    summary.Mean = recordedCount ? static_cast<int64_t>(total.load(std::memory_order_relaxed) / recordedCount) : 0;
+
+    const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+    int64_t* const results[] = { &summary.Median, &summary.P90, &summary.P99, &summary.P999 };
+    size_t bucket = 0;
+    uint64_t accumulated = snapshot[0];
+    for(size_t k = 0; k < 4; ++k) {
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(quantiles[k] * numberOfRecords)));
+        while(accumulated < rank && bucket + 1 < NUMBER_OF_BUCKETS)
+            accumulated += snapshot[++bucket];
+        *results[k] = numberOfRecords ? std::min(static_cast<int64_t>(BucketUpperBound(bucket)), summary.Max) : 0;
+    }
+    return summary;
+}
+
+void LatencyHistogram::Reset()
+{
+    for(std::atomic<uint64_t>& bucketCount : counts)
+        bucketCount.store(0, std::memory_order_relaxed);
+    count.store(0, std::memory_order_relaxed);
+    total.store(0, std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+}
+
+CommandLatencies::CommandLatencies(const std::string& name)
+    : Write(LatencyRegistry::Singleton().Get(name + " write")), Read(LatencyRegistry::Singleton().Get(name + " read")),
+      Reply(LatencyRegistry::Singleton().Get(name + " reply")), Parse(LatencyRegistry::Singleton().Get(name + " parse"))
+{
+}
+
+const CommandLatencies& CommandLatencyCache::Get(const std::string& command)
+{
+    const auto iter = latencies.find(command);
+    if(iter != latencies.end())
+        return iter->second;
+    return latencies.emplace(command, CommandLatencies(prefix + " " + command)).first->second;
+}
+
+LatencyRegistry& LatencyRegistry::Singleton()
+{
+    static LatencyRegistry registry;
+    return registry;
+}
+
+LatencyHistogram& LatencyRegistry::Get(const std::string& name)
+{
+    const std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<LatencyHistogram>& histogram = histograms[name];
+    if(!histogram)
+        histogram.reset(new LatencyHistogram());
+    return *histogram;
+}
+
+void LatencyRegistry::Report(std::ostream& s) const
+{
+    static const int NAME_WIDTH = 40, VALUE_WIDTH = 11;
+    const std::lock_guard<std::mutex> lock(mutex);
+    const std::ios_base::fmtflags flags = s.flags();
+    const std::streamsize precision = s.precision();
+    s << std::left << std::setw(NAME_WIDTH) << "Latency, us" << std::right << std::setw(VALUE_WIDTH) << "count"
+      << std::setw(VALUE_WIDTH) << "mean" << std::setw(VALUE_WIDTH) << "p50" << std::setw(VALUE_WIDTH) << "p90"
+      << std::setw(VALUE_WIDTH) << "p99" << std::setw(VALUE_WIDTH) << "p99.9" << std::setw(VALUE_WIDTH) << "max"
+      << "\n" << std::fixed << std::setprecision(1);
+    for(const auto& histogram : histograms) {
+        const LatencySummary summary = histogram.second->Summary();
+        if(!summary.Count)
+            continue;
+        s << std::left << std::setw(NAME_WIDTH) << histogram.first << std::right << std::setw(VALUE_WIDTH)
+          << summary.Count;
+        for(int64_t value : { summary.Mean, summary.Median, summary.P90, summary.P99, summary.P999, summary.Max })
+            s << std::setw(VALUE_WIDTH) << value / 1000.0;
+        s << "\n";
+    }
+    s.flags(flags);
+    s.precision(precision);
+}
+
+void LatencyRegistry::Reset()
+{
+    const std::lock_guard<std::mutex> lock(mutex);
+    for(const auto& histogram : histograms)
+        histogram.second->Reset();
+}
+
+} // vsc
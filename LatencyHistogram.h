@@ -0,0 +1,169 @@
+/*!
+ * \file LatencyHistogram.h
+ * \brief Definition of LatencyHistogram and LatencyRegistry classes.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <boost/utility.hpp>
+
+#include "date_time.h"
+
+namespace vsc {
+
+/// Summary of a LatencyHistogram. All times are in nanoseconds.
+struct LatencySummary {
+    uint64_t Count;
+    int64_t Mean;
+    int64_t Median;
+    int64_t P90;
+    int64_t P99;
+    int64_t P999;
+    int64_t Max;
+};
+
+/*!
+ * \brief Log-bucketed histogram of latencies in the style of HdrHistogram.
+ *
+ * Each power of two is split into SUB_BUCKETS linear buckets, so any latency up to MAX_LATENCY is stored with the
+ * relative error of at most 1/SUB_BUCKETS (about 3.1%). Record costs a few relaxed atomic increments and never locks, so it can be
+ * called from any thread for every transaction.
+ */
+class LatencyHistogram : private boost::noncopyable {
+public:
+    static const unsigned SUB_BUCKET_BITS = 5;
+    static const uint64_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+
+    /// Larger latencies are recorded as MAX_LATENCY (about 18 minutes).
+    static const uint64_t MAX_LATENCY = (uint64_t(1) << 40) - 1;
+
+    static const size_t NUMBER_OF_BUCKETS = (40 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    LatencyHistogram();
+
+    /// Record a latency in nanoseconds. Negative values are recorded as zero.
+    void Record(int64_t latency);
+
+    /// Returns the summary of the recorded latencies. The percentiles are the upper bounds of their buckets.
+    LatencySummary Summary() const;
+
+    /// Forget all recorded latencies.
+    void Reset();
+
+    static size_t BucketIndex(uint64_t latency);
+    static uint64_t BucketUpperBound(size_t index);
+
+private:
+    std::atomic<uint64_t> counts[NUMBER_OF_BUCKETS];
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> total;
+    std::atomic<int64_t> max;
+};
+
+/*!
+ * \brief Named latency histograms of the whole program.
+ *
+ * Histograms are created on the first use and are never destroyed, so a reference returned by Get stays valid and
+ * can be cached by the frequently called code.
+ */
+class LatencyRegistry : private boost::noncopyable {
+public:
+    static LatencyRegistry& Singleton();
+
+    /// Returns the histogram with the given name.
+    LatencyHistogram& Get(const std::string& name);
+
+    /// Record a latency in nanoseconds into the histogram with the given name.
+    void Record(const std::string& name, int64_t latency) { Get(name).Record(latency); }
+
+    /// Write a table with the summary of all histograms that have at least one record.
+    void Report(std::ostream& s) const;
+
+    /// Reset all histograms.
+    void Reset();
+
+private:
+    LatencyRegistry() {}
+
+private:
+    mutable std::mutex mutex;
+    std::map<std::string, std::unique_ptr<LatencyHistogram>> histograms;
+};
+
+/// Histograms of the stages of a device command.
+struct CommandLatencies {
+    /// Gets the histograms '<name> write', '<name> read', '<name> reply' and '<name> parse' from the registry.
+    explicit CommandLatencies(const std::string& name);
+
+    /// Sending the command.
+    LatencyHistogram& Write;
+
+    /// Reading the reply.
+    LatencyHistogram& Read;
+
+    /// From sending the command until its reply is read.
+    LatencyHistogram& Reply;
+
+    /// Parsing the reply.
+    LatencyHistogram& Parse;
+};
+
+/*!
+ * \brief Caches the CommandLatencies of each command of a device.
+ *
+ * The registry lookups take a lock and build the histogram names, so a driver looks them up only on the first use
+ * of each command. The cache is not thread safe, it should be owned by a single driver instance.
+ */
+class CommandLatencyCache : private boost::noncopyable {
+public:
+    /// \param _prefix - the prefix of the histogram names, e.g. the device name.
+    explicit CommandLatencyCache(const std::string& _prefix) : prefix(_prefix) {}
+
+    /// Returns the histograms of the given command. The reference stays valid while the cache exists.
+    const CommandLatencies& Get(const std::string& command);
+
+private:
+    std::string prefix;
+    std::map<std::string, CommandLatencies> latencies;
+};
+
+/// Records the time between its construction and destruction into a latency histogram.
+class ScopedLatency : private boost::noncopyable {
+public:
+    explicit ScopedLatency(LatencyHistogram& _histogram)
+        : histogram(_histogram), start(DateTimeProvider::ElapsedNanoseconds()) {}
+
+    ~ScopedLatency() { histogram.Record(DateTimeProvider::ElapsedNanoseconds() - start); }
+
+private:
+    LatencyHistogram& histogram;
+    int64_t start;
+};
+
+} // vsc
@@ -35,7 +35,10 @@ MainWindow::MainWindow(vsc::Controller& _controller) :
     QMainWindow(nullptr), ui(new Ui::MainWindow), controller(&_controller)
 {
     ui->setupUi(this);
-    ui->tabWidget->setTabEnabled(ui->tabWidget->indexOf(ui->tabIV), false);
+    ui->plotIT->SetMode(MeasurementPlot::Mode::CurrentVsTime);
+    ui->plotIT->SetSeries(&measurements);
+    ui->plotIV->SetMode(MeasurementPlot::Mode::CurrentVsVoltage);
+    ui->plotIV->SetSeries(&measurements);
 
     normalLabelPalette = ui->labelStatus->palette();
     QBrush brush = normalLabelPalette.windowText();
@@ -71,9 +74,8 @@ void MainWindow::ReportUpdate(const std::string& status_message, const std::stri
 
 void MainWindow::UpdateVoltageSource()
 {
-    ConfigParameters& configParameters = ConfigParameters::ModifiableSingleton();
     const std::string newName = ui->comboBoxVoltageSource->currentText().toStdString();
-    configParameters.setVoltageSource(newName);
+    ConfigParameters::Update([&](ConfigParameters& configParameters) { configParameters.setVoltageSource(newName); });
     ReportUpdate("Connecting...", "Connecting to the voltage source.");
     SetControlStatus(GuiControlStatus::Connecting);
     controller->SendCommand(vsc::Controller::Command::Connect);
@@ -116,6 +118,7 @@ MainWindow::~MainWindow()
 
 void MainWindow::onConnectSuccessful()
 {
+    measurements.Clear();
     ReportUpdate("Connected", "Successfully connected to the voltage source.");
     SetControlStatus(GuiControlStatus::Connected);
 }
@@ -138,6 +141,19 @@ void MainWindow::onDisconnectFailed(const vsc::exception& e)
     SetControlStatus(GuiControlStatus::Disconnected);
 }
 
+void MainWindow::onMeasurements(const std::vector<vsc::IVoltageSource::Measurement>& newMeasurements)
+{
+    if(newMeasurements.empty())
+        return;
+    for(const auto& measurement : newMeasurements)
+        measurements.Append(measurement);
+    const vsc::IVoltageSource::Measurement& measurement = newMeasurements.back();
+    ui->labelVoltage->setText(QString::number(measurement.Voltage / vsc::volts, 'f', 1));
+    ui->labelCurrent->setText(QString::number(measurement.Current / (vsc::micro * vsc::amperes), 'f', 3));
+    ui->plotIT->update();
+    ui->plotIV->update();
+}
+
 void MainWindow::on_pushButtonEnableVoltage_clicked()
 {
 
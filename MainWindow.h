@@ -27,6 +27,7 @@
 #include <QMainWindow>
 #include "exception.h"
 #include "Controller.h"
+#include "MeasurementSeries.h"
 
 namespace Ui {
 class MainWindow;
@@ -63,10 +64,12 @@ public slots:
     void onConnectFailed(const vsc::exception& e);
     void onDisconnectSuccessful();
     void onDisconnectFailed(const vsc::exception& e);
+    void onMeasurements(const std::vector<vsc::IVoltageSource::Measurement>& newMeasurements);
 
 private:
     Ui::MainWindow *ui;
     QPalette errorLabelPalette, normalLabelPalette;
     vsc::Controller *controller;
     GuiControlStatus currentControlStatus;
+    vsc::MeasurementSeries measurements;
 };
@@ -0,0 +1,60 @@
+/*!
+ * \file MeasurementBridge.cc
+ * \brief Implementation of MeasurementBridge class.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "MeasurementBridge.h"
+
+namespace vsc {
+
+bool MeasurementBridge::Push(const IVoltageSource::Measurement& measurement)
+{
+    const std::lock_guard<std::mutex> lock(mutex);
+    const bool wasEmpty = batch.empty();
+    batch.push_back(measurement);
+    return wasEmpty;
+}
+
+bool MeasurementBridge::Pull(std::vector<IVoltageSource::Measurement>& measurements)
+{
+    measurements.clear();
+    const std::lock_guard<std::mutex> lock(mutex);
+    if(batch.empty())
+        return false;
+    batch.swap(measurements);
+    ++statistics.Frames;
+    statistics.Samples += measurements.size();
+    statistics.MaxSamplesPerFrame = std::max(statistics.MaxSamplesPerFrame, measurements.size());
+    return true;
+}
+
+MeasurementBridge::Statistics MeasurementBridge::TakeStatistics()
+{
+    const std::lock_guard<std::mutex> lock(mutex);
+    const Statistics result = statistics;
+    statistics = Statistics();
+    return result;
+}
+
+} // vsc
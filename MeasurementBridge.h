@@ -0,0 +1,73 @@
+/*!
+ * \file MeasurementBridge.h
+ * \brief Definition of MeasurementBridge class.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include <boost/utility.hpp>
+
+#include "IVoltageSource.h"
+
+namespace vsc {
+
+/*!
+ * \brief Passes measurements from the device thread to a consumer thread in batches.
+ *
+ * The device thread pushes each measurement into a batch buffer. The consumer thread, e.g. the GUI thread or the
+ * ControlServer thread, pulls the whole batch once per frame by swapping the buffers, so the number of updates does
+ * not depend on the measurement rate and no memory is allocated in the steady state. The number of measurements
+ * merged per frame is collected in the statistics.
+ */
+class MeasurementBridge : private boost::noncopyable {
+public:
+    /// Statistics of the pulled frames.
+    struct Statistics {
+        size_t Frames, Samples, MaxSamplesPerFrame;
+
+        Statistics() : Frames(0), Samples(0), MaxSamplesPerFrame(0) {}
+        double MeanSamplesPerFrame() const { return Frames ? static_cast<double>(Samples) / Frames : 0; }
+    };
+
+public:
+    /// Add a measurement. Called from the device thread. Returns true if there were no measurements to pull.
+    bool Push(const IVoltageSource::Measurement& measurement);
+
+    /*!
+     * \brief Take all measurements pushed since the previous call. Called from the consumer thread once per frame.
+     * \param measurements - receives the measurements; its previous content is discarded.
+     * \return false if there are no new measurements.
+     */
+    bool Pull(std::vector<IVoltageSource::Measurement>& measurements);
+
+    /// Returns the statistics collected since the previous call and resets them.
+    Statistics TakeStatistics();
+
+private:
+    std::mutex mutex;
+    std::vector<IVoltageSource::Measurement> batch;
+    Statistics statistics;
+};
+
+} // vsc
@@ -0,0 +1,193 @@
+/*!
+ * \file MeasurementPlot.cpp
+ * \brief Implementation of MeasurementPlot class.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <algorithm>
+#include <QPainter>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include "MeasurementPlot.h"
+
+namespace {
+const int MARGIN = 8, LEFT_MARGIN = 70, BOTTOM_MARGIN = 20;
+const double ZOOM_FACTOR = 0.8;
+}
+
+MeasurementPlot::MeasurementPlot(QWidget* parent)
+    : QWidget(parent), mode(Mode::CurrentVsTime), series(nullptr), zoomed(false), zoomBegin(0), zoomEnd(0)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+void MeasurementPlot::SetMode(Mode _mode)
+{
+    mode = _mode;
+    zoomed = false;
+    update();
+}
+
+void MeasurementPlot::SetSeries(const vsc::MeasurementSeries* _series)
+{
+    series = _series;
+    zoomed = false;
+    update();
+}
+
+QRect MeasurementPlot::PlotArea() const
+{
+    return rect().adjusted(LEFT_MARGIN, MARGIN, -MARGIN, -BOTTOM_MARGIN);
+}
+
+bool MeasurementPlot::TimeRange(double& begin, double& end) const
+{
+    if(!series || !series->Size())
+        return false;
+    begin = zoomed ? zoomBegin : series->Time(0);
+    end = zoomed ? zoomEnd : series->Time(series->Size() - 1);
+    if(end <= begin)
+        end = begin + 1;
+    return true;
+}
+
+void MeasurementPlot::FillColumns(int width, std::vector<Column>& result, vsc::MinMaxPyramid::Range& xRange) const
+{
+    result.clear();
+    const vsc::MinMaxPyramid& voltages = series->Voltages();
+    const vsc::MinMaxPyramid& currents = series->Currents();
+    double begin = 0, end = 0;
+    TimeRange(begin, end);
+    size_t first = mode == Mode::CurrentVsTime ? series->LowerBound(begin) : 0;
+    const size_t last = mode == Mode::CurrentVsTime ? series->LowerBound(std::nextafter(end, end + 1))
+                                                   : series->Size();
+    if(mode == Mode::CurrentVsTime)
+        xRange = vsc::MinMaxPyramid::Range(begin, end);
+    else
+        xRange = voltages.Query(first, last);
+
+    for(int x = 0; x < width && first < last; ++x) {
+        size_t next;
+        if(mode == Mode::CurrentVsTime)
+            next = x + 1 == width ? last : series->LowerBound(begin + (end - begin) * (x + 1) / width);
+        else
+            next = static_cast<size_t>(static_cast<double>(last) * (x + 1) / width);
+        if(next <= first)
+            continue;
+        Column column;
+        column.Y = currents.Query(first, next);
+        column.FirstY = currents[first];
+        column.LastY = currents[next - 1];
+        if(mode == Mode::CurrentVsTime) {
+            column.X = vsc::MinMaxPyramid::Range(series->Time(first), series->Time(next - 1));
+            column.FirstX = series->Time(first);
+            column.LastX = series->Time(next - 1);
+        } else {
+            column.X = voltages.Query(first, next);
+            column.FirstX = voltages[first];
+            column.LastX = voltages[next - 1];
+        }
+        result.push_back(column);
+        first = next;
+    }
+}
+
+void MeasurementPlot::paintEvent(QPaintEvent*)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::white);
+    const QRect area = PlotArea();
+    painter.setPen(Qt::gray);
+    painter.drawRect(area);
+    if(!series || !series->Size() || area.width() <= 0 || area.height() <= 0)
+        return;
+
+    vsc::MinMaxPyramid::Range xRange, yRange;
+    FillColumns(area.width(), columns, xRange);
+    for(const Column& column : columns)
+        yRange.Add(column.Y);
+    if(!yRange.IsValid())
+        return;
+    if(xRange.Max <= xRange.Min)
+        xRange.Max = xRange.Min + 1;
+    if(yRange.Max <= yRange.Min) {
+        const double delta = yRange.Min ? std::abs(yRange.Min) * 0.1 : 1e-12;
+        yRange = vsc::MinMaxPyramid::Range(yRange.Min - delta, yRange.Max + delta);
+    }
+
+    const double xScale = (area.width() - 1) / (xRange.Max - xRange.Min);
+    const double yScale = (area.height() - 1) / (yRange.Max - yRange.Min);
+    const auto toPoint = [&](double x, double y) {
+        return QPointF(area.left() + (x - xRange.Min) * xScale, area.bottom() - (y - yRange.Min) * yScale);
+    };
+
+    painter.setPen(Qt::blue);
+    for(size_t n = 0; n < columns.size(); ++n) {
+        const Column& column = columns[n];
+        if(n)
+            painter.drawLine(toPoint(columns[n - 1].LastX, columns[n - 1].LastY),
+                             toPoint(column.FirstX, column.FirstY));
+        painter.drawLine(toPoint(column.FirstX, column.FirstY), toPoint(column.LastX, column.LastY));
+        // In the current versus voltage mode the measurements of one column can span a wide voltage range, so their
+        // current range is drawn over their voltage range.
+        if(mode == Mode::CurrentVsTime)
+            painter.drawLine(toPoint(column.LastX, column.Y.Min), toPoint(column.LastX, column.Y.Max));
+        else
+            painter.drawRect(QRectF(toPoint(column.X.Min, column.Y.Max), toPoint(column.X.Max, column.Y.Min)));
+    }
+
+    const double timeOffset = mode == Mode::CurrentVsTime ? series->Time(0) : 0;
+    const QString xUnits = mode == Mode::CurrentVsTime ? " s" : " V";
+    painter.setPen(Qt::black);
+    painter.drawText(QRect(0, area.top(), LEFT_MARGIN - 4, 20), Qt::AlignRight | Qt::AlignTop,
+                     QString::number(yRange.Max, 'g', 4) + " A");
+    painter.drawText(QRect(0, area.bottom() - 20, LEFT_MARGIN - 4, 20), Qt::AlignRight | Qt::AlignBottom,
+                     QString::number(yRange.Min, 'g', 4) + " A");
+    painter.drawText(QRect(area.left(), area.bottom() + 2, area.width() / 2, BOTTOM_MARGIN - 2), Qt::AlignLeft,
+                     QString::number(xRange.Min - timeOffset, 'g', 6) + xUnits);
+    painter.drawText(QRect(area.center().x(), area.bottom() + 2, area.width() / 2, BOTTOM_MARGIN - 2),
+                     Qt::AlignRight, QString::number(xRange.Max - timeOffset, 'g', 6) + xUnits);
+}
+
+void MeasurementPlot::wheelEvent(QWheelEvent* event)
+{
+    double begin, end;
+    if(mode != Mode::CurrentVsTime || !TimeRange(begin, end)) {
+        event->ignore();
+        return;
+    }
+    const QRect area = PlotArea();
+    const double fraction = std::min(std::max(double(event->pos().x() - area.left()) / area.width(), 0.0), 1.0);
+    const double center = begin + (end - begin) * fraction;
+    const double scale = event->angleDelta().y() > 0 ? ZOOM_FACTOR : 1 / ZOOM_FACTOR;
+    zoomBegin = center - (center - begin) * scale;
+    zoomEnd = center + (end - center) * scale;
+    zoomed = true;
+    event->accept();
+    update();
+}
+
+void MeasurementPlot::mouseDoubleClickEvent(QMouseEvent*)
+{
+    zoomed = false;
+    update();
+}
@@ -0,0 +1,77 @@
+/*!
+ * \file MeasurementPlot.h
+ * \brief Definition of MeasurementPlot class.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QWidget>
+#include "MeasurementSeries.h"
+
+/*!
+ * \brief Plot of the measured current versus time or versus voltage.
+ *
+ * Each repaint queries the MinMaxPyramid containers of the series once per pixel column, so its cost depends on the
+ * widget width and not on the number of measurements. The time plot follows the latest measurements until it is
+ * zoomed with the mouse wheel; a double click returns to the full range.
+ *
+ * In the current versus voltage mode the columns are runs of consecutive measurements, which are drawn as a polyline
+ * through their first and last points. In the time mode the current envelope of a column is drawn as a vertical line,
+ * since a column covers a single pixel on the time axis; in the current versus voltage mode it is drawn as the
+ * rectangle that bounds the voltages and the currents of the run, so no extreme value is lost.
+ */
+class MeasurementPlot : public QWidget
+{
+    Q_OBJECT
+
+public:
+    enum class Mode { CurrentVsTime, CurrentVsVoltage };
+
+public:
+    explicit MeasurementPlot(QWidget* parent = nullptr);
+    void SetMode(Mode _mode);
+    void SetSeries(const vsc::MeasurementSeries* _series);
+
+protected:
+    virtual void paintEvent(QPaintEvent*);
+    virtual void wheelEvent(QWheelEvent* event);
+    virtual void mouseDoubleClickEvent(QMouseEvent*);
+
+private:
+    /// Envelope of the measurements drawn in one pixel column.
+    struct Column {
+        vsc::MinMaxPyramid::Range X, Y;
+        double FirstX, FirstY, LastX, LastY;
+    };
+
+private:
+    QRect PlotArea() const;
+    bool TimeRange(double& begin, double& end) const;
+    void FillColumns(int width, std::vector<Column>& columns, vsc::MinMaxPyramid::Range& xRange) const;
+
+private:
+    Mode mode;
+    const vsc::MeasurementSeries* series;
+    bool zoomed;
+    double zoomBegin, zoomEnd;
+    std::vector<Column> columns;
+};
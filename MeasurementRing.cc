@@ -0,0 +1,185 @@
+/*!
+ * \file MeasurementRing.cc
+ * \brief Implementation of MeasurementRingWriter and MeasurementRingReader classes.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "MeasurementRing.h"
+#include "exception.h"
+
+const char vsc::ring::MAGIC[8] = { 'V', 'S', 'C', 'R', 'I', 'N', 'G', '\0' };
+const uint32_t vsc::ring::VERSION = 1;
+
+namespace {
+const unsigned MAX_CAPACITY = 1u << 24;
+}
+
+const std::vector<std::string>& vsc::MeasurementRingWriter::ConfigSchema()
+{
+    static const std::vector<std::string> schema = { "MeasurementRing", "MeasurementRingCapacity" };
+    return schema;
+}
+
+vsc::MeasurementRingWriter::MeasurementRingWriter(const std::string& _name, unsigned capacity)
+    : name(_name)
+{
+    if(!capacity || capacity > MAX_CAPACITY)
+        THROW_VSC_EXCEPTION("Invalid parameters", "Invalid measurement ring capacity = " << capacity
+                            << ". The capacity should be between 1 and " << MAX_CAPACITY << ".");
+    uint64_t roundedCapacity = 1;
+    while(roundedCapacity < capacity)
+        roundedCapacity *= 2;
+    mask = roundedCapacity - 1;
+    size = sizeof(ring::Header) + roundedCapacity * sizeof(ring::Slot);
+
+    shm_unlink(name.c_str());
+    const int descriptor = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0644);
+    if(descriptor < 0)
+        THROW_VSC_EXCEPTION("Shared memory error", "Unable to create the shared memory object '" << name << "'. "
+                            << std::strerror(errno));
+    void* memory = MAP_FAILED;
+    if(ftruncate(descriptor, static_cast<off_t>(size)) == 0)
+        memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    const int error = errno;
+    close(descriptor);
+    if(memory == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        THROW_VSC_EXCEPTION("Shared memory error", "Unable to map the shared memory object '" << name << "'. "
+                            << std::strerror(error));
+    }
+
+    // The new object is filled with zeros, so all slots are empty and the write cursor is zero.
+    header = static_cast<ring::Header*>(memory);
+    slots = reinterpret_cast<ring::Slot*>(static_cast<char*>(memory) + sizeof(ring::Header));
+    header->version = ring::VERSION;
+    header->capacity = static_cast<uint32_t>(roundedCapacity);
+    header->slotSize = sizeof(ring::Slot);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header->magic, ring::MAGIC, sizeof(ring::MAGIC));
+}
+
+vsc::MeasurementRingWriter::~MeasurementRingWriter()
+{
+    header->closed.store(1, std::memory_order_release);
+    munmap(header, size);
+    shm_unlink(name.c_str());
+}
+
+void vsc::MeasurementRingWriter::Publish(const IVoltageSource::Measurement& measurement)
+{
+    const uint64_t n = header->writeCursor.load(std::memory_order_relaxed);
+    ring::Slot& slot = slots[n & mask];
+    slot.sequence.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.timestamp.store(measurement.Timestamp / vsc::seconds, std::memory_order_relaxed);
+    slot.voltage.store(measurement.Voltage / vsc::volts, std::memory_order_relaxed);
+    slot.current.store(measurement.Current / vsc::amperes, std::memory_order_relaxed);
+    slot.compliance.store(measurement.Compliance ? 1 : 0, std::memory_order_relaxed);
+    slot.sequence.store(2 * (n + 1), std::memory_order_release);
+    header->writeCursor.store(n + 1, std::memory_order_release);
+}
+
+vsc::MeasurementRingReader::MeasurementRingReader(const std::string& name)
+    : lost(0)
+{
+    const int descriptor = shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if(descriptor < 0)
+        THROW_VSC_EXCEPTION("Shared memory error", "Unable to open the shared memory object '" << name << "'. "
+                            << std::strerror(errno));
+    struct stat status;
+    void* memory = MAP_FAILED;
+    if(fstat(descriptor, &status) == 0) {
+        size = static_cast<size_t>(status.st_size);
+        if(size >= sizeof(ring::Header))
+            memory = mmap(nullptr, size, PROT_READ, MAP_SHARED, descriptor, 0);
+    }
+    const int error = errno;
+    close(descriptor);
+    if(memory == MAP_FAILED)
+        THROW_VSC_EXCEPTION("Shared memory error", "Unable to map the shared memory object '" << name << "'. "
+                            << std::strerror(error));
+
+    header = static_cast<const ring::Header*>(memory);
+    slots = reinterpret_cast<const ring::Slot*>(static_cast<const char*>(memory) + sizeof(ring::Header));
+    const bool isRing = std::memcmp(header->magic, ring::MAGIC, sizeof(ring::MAGIC)) == 0;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    capacity = header->capacity;
+    if(!isRing || header->version != ring::VERSION || header->slotSize != sizeof(ring::Slot) || !capacity
+            || (capacity & (capacity - 1)) || size < sizeof(ring::Header) + capacity * sizeof(ring::Slot)) {
+        munmap(const_cast<ring::Header*>(header), size);
+        THROW_VSC_EXCEPTION("Shared memory error", "Shared memory object '" << name << "' is not a measurement ring"
+                            " of version " << ring::VERSION << ".");
+    }
+    const uint64_t cursor = WriteCursor();
+    position = cursor > capacity ? cursor - capacity : 0;
+}
+
+vsc::MeasurementRingReader::~MeasurementRingReader()
+{
+    munmap(const_cast<ring::Header*>(header), size);
+}
+
+bool vsc::MeasurementRingReader::Next(IVoltageSource::Measurement& measurement)
+{
+    for(;;) {
+        const uint64_t cursor = WriteCursor();
+        if(position >= cursor)
+            return false;
+        if(cursor - position > capacity) {
+            lost += cursor - capacity - position;
+            position = cursor - capacity;
+        }
+
+        const ring::Slot& slot = slots[position & (capacity - 1)];
+        const uint64_t expectedSequence = 2 * (position + 1);
+        if(slot.sequence.load(std::memory_order_acquire) == expectedSequence) {
+            const double timestamp = slot.timestamp.load(std::memory_order_relaxed);
+            const double voltage = slot.voltage.load(std::memory_order_relaxed);
+            const double current = slot.current.load(std::memory_order_relaxed);
+            const uint32_t compliance = slot.compliance.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if(slot.sequence.load(std::memory_order_relaxed) == expectedSequence) {
+                measurement = IVoltageSource::Measurement();
+                measurement.Timestamp = timestamp * vsc::seconds;
+                measurement.Voltage = voltage * vsc::volts;
+                measurement.Current = current * vsc::amperes;
+                measurement.Compliance = compliance != 0;
+                ++position;
+                return true;
+            }
+        }
+
+        // The slot is being overwritten, so the writer is a full lap ahead: skip to the oldest slot it won't touch next.
+        const uint64_t newCursor = WriteCursor();
+        const uint64_t oldest = newCursor + 1 > capacity ? newCursor + 1 - capacity : 0;
+        const uint64_t next = std::max(position + 1, oldest);
+        lost += next - position;
+        position = next;
+    }
+}
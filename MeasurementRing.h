@@ -0,0 +1,185 @@
+/*!
+ * \file MeasurementRing.h
+ * \brief Definition of MeasurementRingWriter and MeasurementRingReader classes.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <boost/utility.hpp>
+
+#include "IVoltageSource.h"
+
+namespace vsc {
+namespace ring {
+
+/// Magic string at the beginning of each measurement ring.
+extern const char MAGIC[8];
+
+/// Version of the measurement ring layout.
+extern const uint32_t VERSION;
+
+/*!
+ * \brief Header at the beginning of the shared memory object. It is followed by \a capacity slots.
+ *
+ * The header is written once by the writer, except \a writeCursor and \a closed.
+ */
+struct Header {
+    char magic[8];
+    uint32_t version;
+
+    /// Number of slots. Always a power of two.
+    uint32_t capacity;
+
+    /// Size of a slot in bytes, so a reader can check the layout.
+    uint32_t slotSize;
+
+    /*!
+     * \brief Set to 1 by the writer before it unmaps and removes the ring.
+     *
+     * A new writer with the same name creates a new shared memory object, so the readers of a closed ring should
+     * reopen it to follow the new writer.
+     */
+    std::atomic<uint32_t> closed;
+
+    /// Number of measurements published since the ring was created. Measurement n is stored in slot n % capacity.
+    alignas(64) std::atomic<uint64_t> writeCursor;
+};
+
+/*!
+ * \brief Slot with a single measurement.
+ *
+ * \a sequence is odd while the writer updates the slot and equals 2 * (n + 1) when the slot holds measurement n.
+ * The fields are atomics accessed with the relaxed order, so a reader that races with the writer reads a torn value
+ * instead of invoking undefined behaviour, and detects it by the sequence change.
+ */
+struct alignas(64) Slot {
+    std::atomic<uint64_t> sequence;
+
+    /// Time in seconds on the steady clock of the writer (see DateTimeProvider::ElapsedTime).
+    std::atomic<double> timestamp;
+
+    /// Voltage in Volts.
+    std::atomic<double> voltage;
+
+    /// Current in Amperes.
+    std::atomic<double> current;
+
+    std::atomic<uint32_t> compliance;
+};
+
+// The ring is shared between processes, so the atomics should not use a lock that exists only in one process.
+static_assert(__atomic_always_lock_free(sizeof(uint64_t), 0), "std::atomic<uint64_t> should be lock-free.");
+static_assert(__atomic_always_lock_free(sizeof(double), 0), "std::atomic<double> should be lock-free.");
+static_assert(__atomic_always_lock_free(sizeof(uint32_t), 0), "std::atomic<uint32_t> should be lock-free.");
+
+} // ring
+
+/*!
+ * \brief Publishes measurements into a ring buffer in the POSIX shared memory.
+ *
+ * Any number of local processes can map the ring with MeasurementRingReader and read the measurements without copies
+ * or system calls. The writer never waits for the readers: it simply overwrites the oldest slot, and a reader that
+ * falls behind by more than the capacity loses the overwritten measurements. Publish should be called from a single
+ * thread at a time. When the writer is destroyed, it marks the ring as closed and removes the shared memory object.
+ */
+class MeasurementRingWriter : private boost::noncopyable {
+public:
+    /*!
+     * \brief Create the shared memory object. An existing object with the same name is replaced.
+     * \param name - name of the shared memory object, e.g. "/vsc.hv1".
+     * \param capacity - number of slots, rounded up to a power of two.
+     * \throw vsc::exception if the object can't be created.
+     */
+    MeasurementRingWriter(const std::string& name, unsigned capacity);
+    ~MeasurementRingWriter();
+
+    /// Names of the voltage source configuration parameters that set up the ring.
+    static const std::vector<std::string>& ConfigSchema();
+
+    /// Returns the name of the shared memory object.
+    const std::string& Name() const { return name; }
+
+    /// Store a measurement in the ring.
+    void Publish(const IVoltageSource::Measurement& measurement);
+
+private:
+    std::string name;
+    size_t size;
+    ring::Header* header;
+    ring::Slot* slots;
+    uint64_t mask;
+};
+
+/*!
+ * \brief Reads measurements from a ring created by MeasurementRingWriter, possibly in another process.
+ *
+ * The reader keeps its own position and never modifies the shared memory, so any number of readers can follow the
+ * same ring independently. The mapping stays valid after the writer is destroyed, but no new measurements appear in
+ * it: when Next returns false and IsClosed is true, the reader should be destroyed and created again to follow the
+ * next writer with the same name.
+ */
+class MeasurementRingReader : private boost::noncopyable {
+public:
+    /*!
+     * \brief Map an existing ring. The reader starts from the oldest measurement that is still in the ring.
+     * \throw vsc::exception if the object can't be opened or if it is not a measurement ring.
+     */
+    explicit MeasurementRingReader(const std::string& name);
+    ~MeasurementRingReader();
+
+    /*!
+     * \brief Read the next measurement.
+     * \return false if there are no new measurements.
+     *
+     * If the writer has overwritten the measurements that were not read yet, they are skipped and counted in Lost().
+     */
+    bool Next(IVoltageSource::Measurement& measurement);
+
+    /// Indicates if the writer has closed the ring, i.e. all measurements that will ever be in it are published.
+    bool IsClosed() const { return header->closed.load(std::memory_order_acquire) != 0; }
+
+    /// Returns the number of measurements published so far.
+    uint64_t WriteCursor() const { return header->writeCursor.load(std::memory_order_acquire); }
+
+    /// Returns the index of the next measurement to read.
+    uint64_t Position() const { return position; }
+
+    /// Move to the given measurement index, e.g. WriteCursor() to read only new measurements.
+    void Seek(uint64_t _position) { position = _position; }
+
+    /// Returns the number of measurements skipped because they were overwritten before they were read.
+    uint64_t Lost() const { return lost; }
+
+private:
+    size_t size;
+    const ring::Header* header;
+    const ring::Slot* slots;
+    uint64_t capacity;
+    uint64_t position;
+    uint64_t lost;
+};
+
+} // vsc
@@ -0,0 +1,128 @@
+/*!
+ * \file MeasurementSeries.cc
+ * \brief Implementation of MinMaxPyramid and MeasurementSeries classes.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <limits>
+
+#include "MeasurementSeries.h"
+
+namespace vsc {
+
+MinMaxPyramid::Range::Range()
+    : Min(std::numeric_limits<double>::infinity()), Max(-std::numeric_limits<double>::infinity()) {}
+
+void MinMaxPyramid::Range::Add(double value)
+{
+    Min = std::min(Min, value);
+    Max = std::max(Max, value);
+}
+
+void MinMaxPyramid::Range::Add(const Range& other)
+{
+    Min = std::min(Min, other.Min);
+    Max = std::max(Max, other.Max);
+}
+
+MinMaxPyramid::MinMaxPyramid(size_t _branching)
+    : branching(std::max<size_t>(_branching, 2))
+{
+}
+
+void MinMaxPyramid::Append(double value)
+{
+    size_t index = values.size();
+    values.push_back(value);
+    for(size_t level = 0; ; ++level) {
+        index /= branching;
+        if(level == levels.size()) {
+            const size_t lowerSize = level ? levels.back().size() : values.size();
+            if(lowerSize <= 1)
+                break;
+            std::vector<Range> blocks((lowerSize + branching - 1) / branching);
+            for(size_t n = 0; n < lowerSize; ++n)
+                blocks[n / branching].Add(level ? levels.back()[n] : Range(values[n], values[n]));
+            levels.push_back(blocks);
+            continue;
+        }
+        std::vector<Range>& blocks = levels[level];
+        if(index == blocks.size())
+            blocks.push_back(Range(value, value));
+        else
+            blocks[index].Add(value);
+    }
+}
+
+MinMaxPyramid::Range MinMaxPyramid::Query(size_t begin, size_t end) const
+{
+    Range range;
+    end = std::min(end, values.size());
+    while(begin < end && begin % branching)
+        range.Add(values[begin++]);
+    while(begin < end && end % branching)
+        range.Add(values[--end]);
+    begin /= branching;
+    end /= branching;
+    for(size_t level = 0; begin < end && level < levels.size(); ++level) {
+        const std::vector<Range>& blocks = levels[level];
+        if(level + 1 == levels.size()) {
+            while(begin < end)
+                range.Add(blocks[begin++]);
+            break;
+        }
+        while(begin < end && begin % branching)
+            range.Add(blocks[begin++]);
+        while(begin < end && end % branching)
+            range.Add(blocks[--end]);
+        begin /= branching;
+        end /= branching;
+    }
+    return range;
+}
+
+void MinMaxPyramid::Clear()
+{
+    values.clear();
+    levels.clear();
+}
+
+void MeasurementSeries::Append(const IVoltageSource::Measurement& measurement)
+{
+    times.push_back(measurement.Timestamp / seconds);
+    voltages.Append(measurement.Voltage / volts);
+    currents.Append(measurement.Current / amperes);
+}
+
+size_t MeasurementSeries::LowerBound(double time) const
+{
+    return static_cast<size_t>(std::lower_bound(times.begin(), times.end(), time) - times.begin());
+}
+
+void MeasurementSeries::Clear()
+{
+    times.clear();
+    voltages.Clear();
+    currents.Clear();
+}
+
+} // vsc
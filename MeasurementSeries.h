@@ -0,0 +1,104 @@
+/*!
+ * \file MeasurementSeries.h
+ * \brief Definition of MinMaxPyramid and MeasurementSeries classes.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "IVoltageSource.h"
+
+namespace vsc {
+
+/*!
+ * \brief Sequence of values with precomputed minima and maxima of aligned blocks.
+ *
+ * Level k of the pyramid stores the range of each block of branching^(k+1) consecutive values. Append updates one
+ * block per level, and Query combines at most 2 * branching blocks per level, so the range of any interval is found
+ * in O(branching * log(size)) regardless of the interval length.
+ */
+class MinMaxPyramid {
+public:
+    /// Minimum and maximum of a set of values.
+    struct Range {
+        double Min, Max;
+
+        Range();
+        Range(double min, double max) : Min(min), Max(max) {}
+
+        /// Indicates if the range contains at least one value.
+        bool IsValid() const { return Min <= Max; }
+
+        void Add(double value);
+        void Add(const Range& other);
+    };
+
+public:
+    explicit MinMaxPyramid(size_t branching = 8);
+
+    /// Append a value to the end of the sequence.
+    void Append(double value);
+
+    /// Returns the range of the values with indices in [begin, end).
+    Range Query(size_t begin, size_t end) const;
+
+    size_t Size() const { return values.size(); }
+    double operator[](size_t index) const { return values[index]; }
+    void Clear();
+
+private:
+    size_t branching;
+    std::vector<double> values;
+    std::vector<std::vector<Range>> levels;
+};
+
+/*!
+ * \brief Storage of the measurements optimized for plotting.
+ *
+ * Voltage and current are stored in MinMaxPyramid containers, so the envelope of any number of measurements that
+ * falls into one screen pixel is found without iterating over them. The timestamps should not decrease.
+ */
+class MeasurementSeries {
+public:
+    void Append(const IVoltageSource::Measurement& measurement);
+
+    size_t Size() const { return times.size(); }
+
+    /// Returns the timestamp in seconds of the given measurement.
+    double Time(size_t index) const { return times[index]; }
+
+    /// Returns the index of the first measurement with timestamp not earlier than \a time in seconds.
+    size_t LowerBound(double time) const;
+
+    const MinMaxPyramid& Voltages() const { return voltages; }
+    const MinMaxPyramid& Currents() const { return currents; }
+
+    void Clear();
+
+private:
+    std::vector<double> times;
+    MinMaxPyramid voltages, currents;
+};
+
+} // vsc
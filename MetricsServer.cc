@@ -0,0 +1,282 @@
+/*!
+ * \file MetricsServer.cc
+ * \brief Implementation of MetricsServer class.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <netinet/in.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "exception.h"
+#include "log.h"
+#include "MetricsServer.h"
+#include "Trace.h"
+
+namespace {
+const std::string LOG_HEAD = "MetricsServer";
+
+/// A client that sends a longer request header is disconnected.
+const size_t MAX_REQUEST_SIZE = 8192;
+
+std::string HttpResponse(const std::string& status, const std::string& contentType, const std::string& body)
+{
+    std::ostringstream ss;
+    ss << "HTTP/1.0 " << status << "\r\nContent-Type: " << contentType << "\r\nContent-Length: " << body.size()
+       << "\r\nConnection: close\r\n\r\n" << body;
+    return ss.str();
+}
+
+void WriteMetricHeader(std::ostream& s, const std::string& name, const std::string& type, const std::string& help)
+{
+    s << "# HELP " << name << " " << help << "\n# TYPE " << name << " " << type << "\n";
+}
+}
+
+namespace vsc {
+
+const size_t MetricsServer::RATE_WINDOW;
+
+MetricsServer::MetricsServer(Controller& _controller, unsigned port)
+    : controller(_controller), numberOfMeasurements(0), numberOfComplianceEvents(0)
+{
+    if(!port || port > 65535)
+        THROW_VSC_EXCEPTION("Metrics server error", "Invalid port number = " << port << ".");
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    listenDescriptor = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(listenDescriptor < 0)
+        THROW_VSC_EXCEPTION("Metrics server error", "Unable to create a socket. " << std::strerror(errno));
+    const int reuseAddress = 1;
+    setsockopt(listenDescriptor, SOL_SOCKET, SO_REUSEADDR, &reuseAddress, sizeof(reuseAddress));
+    if(bind(listenDescriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+            || listen(listenDescriptor, SOMAXCONN) != 0) {
+        const int error = errno;
+        close(listenDescriptor);
+        THROW_VSC_EXCEPTION("Metrics server error", "Unable to listen on port " << port << ". "
+                            << std::strerror(error));
+    }
+    if(pipe(stopPipe) != 0) {
+        const int error = errno;
+        close(listenDescriptor);
+        THROW_VSC_EXCEPTION("Metrics server error", "Unable to create a pipe. " << std::strerror(error));
+    }
+
+    controller.AddOnMeasurementCallback(std::bind(&MetricsServer::onMeasurement, this, std::placeholders::_1));
+    controller.AddOnComplianceCallback(std::bind(&MetricsServer::onCompliance, this));
+
+    thread = std::thread(&MetricsServer::Run, this);
+}
+
+MetricsServer::~MetricsServer()
+{
+    const char stop = 0;
+    if(write(stopPipe[1], &stop, 1) != 1)
+        LogError(LOG_HEAD) << "Unable to stop the server thread.\n";
+    thread.join();
+    for(const Client& client : clients)
+        close(client.descriptor);
+    close(stopPipe[0]);
+    close(stopPipe[1]);
+    close(listenDescriptor);
+}
+
+std::string MetricsServer::Metrics()
+{
+    IVoltageSource::Measurement measurement;
+    uint64_t measurementCount, complianceCount;
+    double measurementRate = 0;
+    {
+        const std::lock_guard<std::mutex> lock(statusMutex);
+        measurement = lastMeasurement;
+        measurementCount = numberOfMeasurements;
+        complianceCount = numberOfComplianceEvents;
+        const size_t windowSize = std::min<uint64_t>(numberOfMeasurements, RATE_WINDOW);
+        if(windowSize >= 2) {
+            const Time newest = measurementTimes[(numberOfMeasurements - 1) % RATE_WINDOW];
+            const Time oldest = measurementTimes[(numberOfMeasurements - windowSize) % RATE_WINDOW];
+            if(newest > oldest)
+                measurementRate = (windowSize - 1) / static_cast<double>((newest - oldest) / seconds);
+        }
+    }
+
+    std::ostringstream s;
+    s.precision(10);
+    const std::vector<Controller::CommandStatistics> commands = controller.GetCommandStatistics();
+    WriteMetricHeader(s, "vsc_commands_total", "counter", "Number of executed controller commands.");
+    for(const Controller::CommandStatistics& command : commands)
+        s << "vsc_commands_total{command=\"" << command.Name << "\"} " << command.Executed << "\n";
+    WriteMetricHeader(s, "vsc_command_errors_total", "counter", "Number of failed controller commands.");
+    for(const Controller::CommandStatistics& command : commands)
+        s << "vsc_command_errors_total{command=\"" << command.Name << "\"} " << command.Failed << "\n";
+    WriteMetricHeader(s, "vsc_command_queue_depth", "gauge", "Number of commands waiting to be executed.");
+    s << "vsc_command_queue_depth " << controller.CommandQueueSize() << "\n";
+    WriteMetricHeader(s, "vsc_compliance_events_total", "counter", "Number of measurements in compliance.");
+    s << "vsc_compliance_events_total " << complianceCount << "\n";
+    WriteMetricHeader(s, "vsc_measurements_total", "counter", "Number of measurements.");
+    s << "vsc_measurements_total " << measurementCount << "\n";
+    WriteMetricHeader(s, "vsc_measurement_rate_hertz", "gauge", "Rate of the latest measurements.");
+    s << "vsc_measurement_rate_hertz " << measurementRate << "\n";
+    WriteMetricHeader(s, "vsc_voltage_volts", "gauge", "Last measured voltage.");
+    s << "vsc_voltage_volts " << static_cast<double>(measurement.Voltage / volts) << "\n";
+    WriteMetricHeader(s, "vsc_current_amperes", "gauge", "Last measured current.");
+    s << "vsc_current_amperes " << static_cast<double>(measurement.Current / amperes) << "\n";
+    WriteMetricHeader(s, "vsc_log_backlog_records", "gauge", "Number of log records waiting to be written.");
+    s << "vsc_log_backlog_records " << log::AsyncLogWriter::Singleton().Backlog() << "\n";
+    return s.str();
+}
+
+void MetricsServer::Run()
+{
+    Tracer::Singleton().SetThreadName("MetricsServer");
+    std::vector<pollfd> descriptors;
+    for(;;) {
+        descriptors.clear();
+        descriptors.push_back({ stopPipe[0], POLLIN, 0 });
+        descriptors.push_back({ listenDescriptor, POLLIN, 0 });
+        for(const Client& client : clients) {
+            const short events = client.output.empty() ? POLLIN : POLLOUT;
+            descriptors.push_back({ client.descriptor, events, 0 });
+        }
+
+        const int result = poll(descriptors.data(), descriptors.size(), -1);
+        if(result < 0 && errno == EINTR)
+            continue;
+        if(result < 0 || descriptors[0].revents)
+            return;
+        if(descriptors[1].revents)
+            Accept();
+
+        size_t n = 2;
+        for(auto iter = clients.begin(); iter != clients.end() && n < descriptors.size(); ++n) {
+            const short revents = descriptors[n].revents;
+            bool ok = !(revents & (POLLERR | POLLNVAL));
+            if(ok && !iter->responded && (revents & (POLLIN | POLLHUP)))
+                ok = Receive(*iter);
+            if(ok && iter->responded)
+                ok = Transmit(*iter);
+            if(ok)
+                ++iter;
+            else {
+                close(iter->descriptor);
+                iter = clients.erase(iter);
+            }
+        }
+    }
+}
+
+void MetricsServer::Accept()
+{
+    int descriptor;
+    while((descriptor = accept4(listenDescriptor, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+        Client client;
+        client.descriptor = descriptor;
+        client.responded = false;
+        clients.push_back(client);
+    }
+}
+
+bool MetricsServer::Receive(Client& client)
+{
+    char buffer[4096];
+    bool endOfStream = false;
+    for(;;) {
+        const ssize_t length = recv(client.descriptor, buffer, sizeof(buffer), 0);
+        if(length > 0) {
+            client.input.append(buffer, length);
+            continue;
+        }
+        if(length < 0 && errno == EINTR)
+            continue;
+        if(length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        if(length < 0)
+            return false;
+        endOfStream = true;
+        break;
+    }
+
+    // A client that shut down its side of the connection can't complete the request, so it is answered as it is.
+    if(client.input.find("\r\n\r\n") == std::string::npos && client.input.find("\n\n") == std::string::npos) {
+        if(!endOfStream)
+            return client.input.size() <= MAX_REQUEST_SIZE;
+        if(client.input.empty())
+            return false;
+    }
+
+    std::istringstream request(client.input);
+    std::string method, target;
+    request >> method >> target;
+    const std::string path = target.substr(0, target.find('?'));
+    if(method != "GET")
+        client.output = HttpResponse("405 Method Not Allowed", "text/plain", "Only GET is supported.\n");
+    else if(path != "/metrics")
+        client.output = HttpResponse("404 Not Found", "text/plain", "Metrics are served at /metrics.\n");
+    else
+        client.output = HttpResponse("200 OK", "text/plain; version=0.0.4; charset=utf-8", Metrics());
+    client.responded = true;
+    return true;
+}
+
+bool MetricsServer::Transmit(Client& client)
+{
+    size_t position = 0;
+    while(position < client.output.size()) {
+        const ssize_t length = send(client.descriptor, client.output.data() + position,
+                                    client.output.size() - position, MSG_NOSIGNAL);
+        if(length > 0)
+            position += length;
+        else if(length < 0 && errno == EINTR)
+            continue;
+        else if(length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        else
+            return false;
+    }
+    // The connection is closed as soon as the whole response is sent.
+    client.output.erase(0, position);
+    return !client.output.empty();
+}
+
+void MetricsServer::onMeasurement(const IVoltageSource::Measurement& measurement)
+{
+    const std::lock_guard<std::mutex> lock(statusMutex);
+    lastMeasurement = measurement;
+    measurementTimes[numberOfMeasurements % RATE_WINDOW] = measurement.Timestamp;
+    ++numberOfMeasurements;
+}
+
+void MetricsServer::onCompliance()
+{
+    const std::lock_guard<std::mutex> lock(statusMutex);
+    ++numberOfComplianceEvents;
+}
+
+} // vsc
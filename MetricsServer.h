@@ -0,0 +1,94 @@
+/*!
+ * \file MetricsServer.h
+ * \brief Definition of MetricsServer class.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/utility.hpp>
+
+#include "Controller.h"
+
+namespace vsc {
+/*!
+ * \brief Serves the controller metrics in the Prometheus text format over HTTP on the loopback interface.
+ *
+ * The server understands only "GET /metrics" and closes the connection after each response, which is enough for
+ * the Prometheus scraper and for curl. The metrics are the command counters and errors, the compliance events, the
+ * last measured voltage and current, the measurement rate, the depth of the command queue and the backlog of the
+ * asynchronous log writer. The socket is served by a single thread with non-blocking I/O.
+ */
+class MetricsServer : private boost::noncopyable {
+public:
+    /*!
+     * \brief Listen on 127.0.0.1:port and start serving.
+     * \throw vsc::exception if the port can't be opened.
+     *
+     * The server subscribes to the controller events, so it should be destroyed only after the controller thread is
+     * stopped.
+     */
+    MetricsServer(Controller& controller, unsigned port);
+
+    /// Disconnect all clients and stop the server thread.
+    ~MetricsServer();
+
+    /// Returns the metrics in the Prometheus text format.
+    std::string Metrics();
+
+private:
+    struct Client {
+        int descriptor;
+        bool responded;
+        std::string input, output;
+    };
+
+    /// Number of the latest measurements used to estimate the measurement rate.
+    static const size_t RATE_WINDOW = 32;
+
+private:
+    void Run();
+    void Accept();
+    bool Receive(Client& client);
+    bool Transmit(Client& client);
+
+    void onMeasurement(const IVoltageSource::Measurement& measurement);
+    void onCompliance();
+
+private:
+    Controller& controller;
+    int listenDescriptor;
+    int stopPipe[2];
+    std::list<Client> clients;
+    std::thread thread;
+
+    std::mutex statusMutex;
+    IVoltageSource::Measurement lastMeasurement;
+    uint64_t numberOfMeasurements, numberOfComplianceEvents;
+    Time measurementTimes[RATE_WINDOW];
+};
+
+} // vsc
@@ -0,0 +1,120 @@
+/*!
+ * \file MpscQueue.h
+ * \brief Definition of MpscQueue class.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <boost/utility.hpp>
+
+namespace vsc {
+/*!
+ * \brief Unbounded lock-free queue with multiple producers and a single consumer.
+ *
+ * Push can be called from any thread and never blocks: it costs one allocation and one atomic exchange. Pop should
+ * be called only from the single consumer thread. The algorithm is the intrusive node-based queue by D. Vyukov.
+ */
+template<typename Value>
+class MpscQueue : private boost::noncopyable {
+private:
+    struct Node {
+        std::atomic<Node*> next;
+        Value value;
+
+        Node() : next(nullptr) {}
+        explicit Node(const Value& _value) : next(nullptr), value(_value) {}
+        explicit Node(Value&& _value) : next(nullptr), value(std::move(_value)) {}
+    };
+
+public:
+    MpscQueue() : head(new Node()), tail(head.load()), size(0) {}
+
+    ~MpscQueue()
+    {
+        Value value;
+        while(Pop(value)) {}
+        delete tail;
+    }
+
+    /// Add a value to the queue. Safe to call from any number of threads.
+    void Push(const Value& value)
+    {
+        Link(new Node(value));
+    }
+
+    /// Move a value into the queue. Safe to call from any number of threads.
+    void Push(Value&& value)
+    {
+        Link(new Node(std::move(value)));
+    }
+
+    /*!
+     * \brief Take the oldest value from the queue. Should be called only from the consumer thread.
+     * \return false if the queue is empty.
+     */
+    bool Pop(Value& value)
+    {
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if(!next)
+            return false;
+        value = std::move(next->value);
+        delete tail;
+        tail = next;
+        size.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /*!
+     * \brief Call \a function for each value in the queue without removing it. Should be called only from the consumer
+     *        thread, or when the consumer is known to be stopped.
+     *
+     * Nothing is locked, allocated or freed, so it can be used in a signal handler.
+     */
+    template<typename Function>
+    void ForEach(Function function) const
+    {
+        for(Node* node = tail->next.load(std::memory_order_acquire); node;
+            node = node->next.load(std::memory_order_acquire))
+            function(static_cast<const Value&>(node->value));
+    }
+
+    /// Returns an approximate number of values in the queue.
+    size_t Size() const { return size.load(std::memory_order_relaxed); }
+
+private:
+    void Link(Node* node)
+    {
+        size.fetch_add(1, std::memory_order_relaxed);
+        Node* previous = head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+private:
+    std::atomic<Node*> head;
+    Node* tail;
+    std::atomic<size_t> size;
+};
+
+} // vsc
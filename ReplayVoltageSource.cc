@@ -0,0 +1,100 @@
+/*!
+ * \file ReplayVoltageSource.cc
+ * \brief Implementation of ReplayVoltageSource class.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ReplayVoltageSource.h"
+#include "EventLog.h"
+#include "DriverRegistry.h"
+#include "ConfigParameters.h"
+#include "date_time.h"
+#include "exception.h"
+
+namespace vsc {
+
+const int ReplayVoltageSource::ALL_SOURCES;
+
+ReplayVoltageSource::ReplayVoltageSource(const std::string& _fileName, double _speedUp, int source, bool _loop)
+    : fileName(_fileName), speedUp(_speedUp), loop(_loop), position(0), startTime(0), loopOffset(0),
+      loopDuration(0)
+{
+    EventLogReader reader(fileName);
+    events::Record record;
+    RecordedMeasurement measurement;
+    while(reader.Next(record)) {
+        if(source != ALL_SOURCES && record.header.source != source)
+            continue;
+        if(!EventLogReader::DecodeMeasurement(record, measurement.Value))
+            continue;
+        measurement.Time = record.header.time;
+        records.push_back(measurement);
+    }
+    if(records.empty())
+        THROW_VSC_EXCEPTION("Invalid event log", "Event log '" << fileName << "' has no measurements to replay.");
+    const int64_t span = records.back().Time - records.front().Time;
+    loopDuration = records.size() > 1 ? span + span / static_cast<int64_t>(records.size() - 1) : 0;
+}
+
+IVoltageSource::Value ReplayVoltageSource::Set(const Value& value)
+{
+    return value;
+}
+
+ElectricPotential ReplayVoltageSource::Accuracy(const ElectricPotential&)
+{
+    static const ElectricPotential accuracy = 0.1 * volts;
+    return accuracy;
+}
+
+IVoltageSource::Measurement ReplayVoltageSource::Measure()
+{
+    if(position == records.size()) {
+        if(!loop)
+            THROW_VSC_EXCEPTION("Replay finished", "All measurements from '" << fileName << "' are replayed.");
+        position = 0;
+        loopOffset += loopDuration;
+    }
+    const RecordedMeasurement& recorded = records[position++];
+    if(!startTime)
+        startTime = DateTimeProvider::ElapsedNanoseconds();
+    if(speedUp > 0) {
+        const double delay = (recorded.Time - records.front().Time + loopOffset) / speedUp;
+        SleepUntil(startTime + static_cast<int64_t>(delay));
+    }
+    Measurement measurement = recorded.Value;
+    measurement.Timestamp = DateTimeProvider::ElapsedTime();
+    return measurement;
+}
+
+void ReplayVoltageSource::Off() {}
+
+} // vsc
+
+static vsc::IVoltageSource* ReplayVoltageSourceMaker(const VoltageSourceConfig& config)
+{
+    return new vsc::ReplayVoltageSource(config.Device(), config.ExtraParameter("SpeedUp", 1.0),
+                                        config.ExtraParameter("Source", vsc::ReplayVoltageSource::ALL_SOURCES),
+                                        config.ExtraParameter("Loop", false));
+}
+
+VSC_REGISTER_DRIVER(Replay, &ReplayVoltageSourceMaker, vsc::DriverCapability::Simulation,
+                    "Device", "SpeedUp", "Source", "Loop");
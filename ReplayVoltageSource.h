@@ -0,0 +1,91 @@
+/*!
+ * \file ReplayVoltageSource.h
+ * \brief Definition of ReplayVoltageSource class.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "IVoltageSource.h"
+
+namespace vsc {
+
+/*!
+ * \brief Voltage source that replays measurements recorded in the event log.
+ *
+ * All measurement records of the selected source are loaded when the object is created. Each Measure
+ * returns the next recorded measurement at the time when it was recorded, relative to the first Measure call and
+ * divided by the speed-up factor. A non-positive speed-up returns the records as fast as possible. Set and Off are
+ * accepted but do not change the replayed values. The timestamps of the returned measurements are the replay times,
+ * while the device timestamps are kept as they were recorded.
+ */
+class ReplayVoltageSource : public IVoltageSource {
+public:
+    /// Replay records of any source.
+    static const int ALL_SOURCES = -1;
+
+    /*!
+     * \brief Load the measurements to replay.
+     * \param fileName - the event log file.
+     * \param speedUp - how many times the replay is faster than the recorded session.
+     * \param source - identifier of the recorded source (see the EventSource parameter) or ALL_SOURCES.
+     * \param loop - start again from the first record when all records are replayed.
+     * \throw vsc::exception if the file can't be read or has no measurements.
+     */
+    ReplayVoltageSource(const std::string& fileName, double speedUp, int source, bool loop);
+
+    /// \copydoc IVoltageSource::Set
+    virtual Value Set(const Value& value);
+
+    /// \copydoc IVoltageSource::Accuracy
+    virtual ElectricPotential Accuracy(const ElectricPotential& voltage);
+
+    /*!
+     * \copydoc IVoltageSource::Measure
+     * \throw vsc::exception if all records are replayed and the replay is not looped.
+     */
+    virtual Measurement Measure();
+
+    /// \copydoc IVoltageSource::Off
+    virtual void Off();
+
+    /// Returns the number of the loaded measurements.
+    size_t Size() const { return records.size(); }
+
+private:
+    struct RecordedMeasurement {
+        int64_t Time;
+        Measurement Value;
+    };
+
+private:
+    std::string fileName;
+    double speedUp;
+    bool loop;
+    std::vector<RecordedMeasurement> records;
+    size_t position;
+    int64_t startTime, loopOffset, loopDuration;
+};
+
+} // vsc
@@ -0,0 +1,240 @@
+/*!
+ * \file SimulatedVoltageSource.cc
+ * \brief Implementation of SimulatedVoltageSource class.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <algorithm>
+
+#include "SimulatedVoltageSource.h"
+#include "DriverRegistry.h"
+#include "ConfigParameters.h"
+#include "date_time.h"
+#include "exception.h"
+
+namespace {
+/// Coefficients of the pink noise filter by P. Kellet.
+const double PINK_POLES[] = { 0.99886, 0.99332, 0.96900, 0.86650, 0.55000, -0.7616 };
+const double PINK_GAINS[] = { 0.0555179, 0.0750759, 0.1538520, 0.3104856, 0.5329522, -0.0168980 };
+const double PINK_DIRECT_GAIN = 0.5362, PINK_DELAYED_GAIN = 0.115926;
+
+/// Standard deviation of the filter output for the white input with unit standard deviation.
+const double PINK_NORMALIZATION = 3.03;
+
+double Sign(double x) { return x < 0 ? -1.0 : 1.0; }
+}
+
+namespace vsc {
+
+SimulationProfile SimulationProfile::Get(const std::string& name)
+{
+    SimulationProfile profile;
+    profile.Name = name;
+    if(name == "Keithley237") {
+        profile.Connect = LatencyDistribution(3.0 * seconds, 0.1);
+        profile.Set = LatencyDistribution(120.0 * milli * seconds, 0.2);
+        profile.Measure = LatencyDistribution(25.0 * milli * seconds, 0.15);
+        profile.Off = LatencyDistribution(30.0 * milli * seconds, 0.2);
+        profile.Accuracy = 0.1 * volts;
+    } else if(name == "Keithley6487") {
+        profile.Connect = LatencyDistribution(1.2 * seconds, 0.1);
+        profile.Set = LatencyDistribution(60.0 * milli * seconds, 0.2);
+        profile.Measure = LatencyDistribution(35.0 * milli * seconds, 0.15);
+        profile.Off = LatencyDistribution(20.0 * milli * seconds, 0.2);
+        profile.Accuracy = 0.1 * volts;
+    } else if(name == "Ideal") {
+        profile.Accuracy = 1.0 * milli * volts;
+    } else
+        THROW_VSC_EXCEPTION("Invalid configuration", "Unknown simulation profile '" << name << "'.");
+    return profile;
+}
+
+SimulatedVoltageSource::Parameters::Parameters()
+    : LoadResistance(100.0 * mega * ohms), SeriesResistance(1.0 * mega * ohms),
+      LoadCapacitance(1.0 * nano * farads), WhiteNoise(1.0 * pico * amperes), FlickerNoise(0.5 * pico * amperes),
+      BreakdownVoltage(0.0 * volts), BreakdownResistance(1.0 * mega * ohms) {}
+
+SimulatedVoltageSource::SimulatedVoltageSource(const Parameters& _parameters, const SimulationProfile& _profile,
+                                               bool _virtualClock, unsigned long long seed)
+    : parameters(_parameters), profile(_profile), virtualClock(_virtualClock), generator(seed),
+      targetVoltage(0), outputVoltage(0), compliance(0)
+{
+    if(parameters.LoadResistance <= 0.0 * ohms)
+        THROW_VSC_EXCEPTION("Invalid configuration", "Load resistance of the simulated source should be positive.");
+    if(parameters.BreakdownVoltage > 0.0 * volts && parameters.BreakdownResistance <= 0.0 * ohms)
+        THROW_VSC_EXCEPTION("Invalid configuration", "Breakdown resistance of the simulated source should be"
+                            " positive.");
+    std::fill(pink, pink + 7, 0.0);
+    virtualTime = DateTimeProvider::ElapsedTime() / seconds;
+    Wait(profile.Connect);
+    lastUpdateTime = Now() / seconds;
+}
+
+IVoltageSource::Value SimulatedVoltageSource::Set(const Value& value)
+{
+    Wait(profile.Set);
+    Evolve();
+    targetVoltage = value.Voltage / volts;
+    compliance = value.Compliance / amperes;
+    return value;
+}
+
+ElectricPotential SimulatedVoltageSource::Accuracy(const ElectricPotential&)
+{
+    return profile.Accuracy;
+}
+
+IVoltageSource::Measurement SimulatedVoltageSource::Measure()
+{
+    Wait(profile.Measure);
+    Evolve();
+    const double seriesResistance = parameters.SeriesResistance / ohms;
+    const double limit = ComplianceVoltage(compliance);
+    const double settledVoltage = Sign(targetVoltage) * std::min(std::abs(targetVoltage), limit);
+    const double chargingCurrent = seriesResistance > 0 ? (settledVoltage - outputVoltage) / seriesResistance : 0;
+    double current = LoadCurrent(outputVoltage) + chargingCurrent;
+    bool inCompliance = std::abs(targetVoltage) > limit;
+    if(compliance > 0 && std::abs(current) > compliance) {
+        current = Sign(current) * compliance;
+        inCompliance = true;
+    }
+    current += Noise();
+    return Measurement(current * amperes, outputVoltage * volts, Now(), inCompliance);
+}
+
+void SimulatedVoltageSource::Off()
+{
+    Wait(profile.Off);
+    Evolve();
+    targetVoltage = 0;
+}
+
+Time SimulatedVoltageSource::Now() const
+{
+    return virtualClock ? virtualTime * seconds : DateTimeProvider::ElapsedTime();
+}
+
+void SimulatedVoltageSource::AdvanceTime(const Time& interval)
+{
+    if(virtualClock)
+        virtualTime += interval / seconds;
+    else
+        Sleep(interval);
+}
+
+int64_t SimulatedVoltageSource::ElapsedNanoseconds()
+{
+    return static_cast<int64_t>(std::llround(Now() / (nano * seconds)));
+}
+
+int64_t SimulatedVoltageSource::SleepUntil(int64_t deadline, int64_t spinInterval)
+{
+    if(!virtualClock)
+        return vsc::SleepUntil(deadline, spinInterval);
+    const int64_t now = ElapsedNanoseconds();
+    if(now >= deadline)
+        return now - deadline;
+    virtualTime = static_cast<double>(deadline) * 1e-9;
+    return 0;
+}
+
+void SimulatedVoltageSource::Wait(const LatencyDistribution& latency)
+{
+    if(latency.Median <= 0.0 * seconds)
+        return;
+    AdvanceTime(latency.Median * std::exp(latency.Sigma * normal(generator)));
+}
+
+void SimulatedVoltageSource::Evolve()
+{
+    const double now = Now() / seconds;
+    const double interval = now - lastUpdateTime;
+    lastUpdateTime = now;
+    const double limit = ComplianceVoltage(compliance);
+    const double settledVoltage = Sign(targetVoltage) * std::min(std::abs(targetVoltage), limit);
+    const double tau = parameters.SeriesResistance / ohms * (parameters.LoadCapacitance / farads);
+    if(tau <= 0)
+        outputVoltage = settledVoltage;
+    else if(interval > 0)
+        outputVoltage = settledVoltage + (outputVoltage - settledVoltage) * std::exp(-interval / tau);
+}
+
+double SimulatedVoltageSource::LoadCurrent(double voltage) const
+{
+    double current = voltage / (parameters.LoadResistance / ohms);
+    const double breakdownVoltage = parameters.BreakdownVoltage / volts;
+    if(breakdownVoltage > 0 && std::abs(voltage) > breakdownVoltage)
+        current += Sign(voltage) * (std::abs(voltage) - breakdownVoltage) / (parameters.BreakdownResistance / ohms);
+    return current;
+}
+
+double SimulatedVoltageSource::ComplianceVoltage(double complianceCurrent) const
+{
+    if(complianceCurrent <= 0 || std::abs(LoadCurrent(targetVoltage)) <= complianceCurrent)
+        return std::abs(targetVoltage);
+    double low = 0, high = std::abs(targetVoltage);
+    for(unsigned n = 0; n < 64; ++n) {
+        const double middle = (low + high) / 2;
+        if(LoadCurrent(middle) > complianceCurrent)
+            high = middle;
+        else
+            low = middle;
+    }
+    return low;
+}
+
+double SimulatedVoltageSource::Noise()
+{
+    const double white = normal(generator);
+    double flicker = pink[6] + white * PINK_DIRECT_GAIN;
+    for(unsigned n = 0; n < 6; ++n) {
+        pink[n] = PINK_POLES[n] * pink[n] + white * PINK_GAINS[n];
+        flicker += pink[n];
+    }
+    pink[6] = white * PINK_DELAYED_GAIN;
+    return normal(generator) * (parameters.WhiteNoise / amperes)
+            + flicker / PINK_NORMALIZATION * (parameters.FlickerNoise / amperes);
+}
+
+} // vsc
+
+static vsc::IVoltageSource* SimulatedVoltageSourceMaker(const VoltageSourceConfig& config)
+{
+    vsc::SimulatedVoltageSource::Parameters parameters;
+    parameters.LoadResistance = config.ExtraParameter("Resistance", parameters.LoadResistance);
+    parameters.SeriesResistance = config.ExtraParameter("SeriesResistance", parameters.SeriesResistance);
+    parameters.LoadCapacitance = config.ExtraParameter("Capacitance", parameters.LoadCapacitance);
+    parameters.WhiteNoise = config.ExtraParameter("WhiteNoise", parameters.WhiteNoise);
+    parameters.FlickerNoise = config.ExtraParameter("FlickerNoise", parameters.FlickerNoise);
+    parameters.BreakdownVoltage = config.ExtraParameter("BreakdownVoltage", parameters.BreakdownVoltage);
+    parameters.BreakdownResistance = config.ExtraParameter("BreakdownResistance", parameters.BreakdownResistance);
+    const vsc::SimulationProfile profile =
+            vsc::SimulationProfile::Get(config.ExtraParameter<std::string>("Profile", "Ideal"));
+    unsigned long long seed = config.ExtraParameter<unsigned long long>("Seed", 0);
+    if(!seed)
+        seed = std::random_device()();
+    return new vsc::SimulatedVoltageSource(parameters, profile, config.ExtraParameter("VirtualClock", false), seed);
+}
+
+VSC_REGISTER_DRIVER(Simulator, &SimulatedVoltageSourceMaker, vsc::DriverCapability::Simulation,
+                    "Profile", "Resistance", "SeriesResistance", "Capacitance", "WhiteNoise", "FlickerNoise",
+                    "BreakdownVoltage", "BreakdownResistance", "VirtualClock", "Seed");
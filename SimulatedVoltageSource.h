@@ -0,0 +1,147 @@
+/*!
+ * \file SimulatedVoltageSource.h
+ * \brief Definition of SimulatedVoltageSource class.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <random>
+#include <string>
+
+#include "IVoltageSource.h"
+
+namespace vsc {
+
+/*!
+ * \brief Log-normal distribution of the time that the device needs to complete an operation.
+ *
+ * Real instruments have a long tail of slow replies, which a log-normal distribution reproduces well enough.
+ */
+struct LatencyDistribution {
+    /// Median latency.
+    Time Median;
+
+    /// Standard deviation of the latency logarithm.
+    double Sigma;
+
+    LatencyDistribution() : Median(0.0 * seconds), Sigma(0) {}
+    LatencyDistribution(const Time& median, double sigma) : Median(median), Sigma(sigma) {}
+};
+
+/*!
+ * \brief Timing and accuracy of the simulated instrument.
+ */
+struct SimulationProfile {
+    std::string Name;
+    LatencyDistribution Connect, Set, Measure, Off;
+    ElectricPotential Accuracy;
+
+    /// Returns the profile with the given name: "Keithley237", "Keithley6487" or "Ideal".
+    /// \throw vsc::exception if there is no such profile.
+    static SimulationProfile Get(const std::string& name);
+};
+
+/*!
+ * \brief Voltage source that simulates a detector connected to a real instrument.
+ *
+ * The load is a resistor in parallel with a capacitor, charged through a series resistance, so the output voltage
+ * settles exponentially after each Set and the measured current includes the charging current. Above the breakdown
+ * voltage an additional current flows through the breakdown resistance. The current is clamped at the compliance
+ * value, and the output voltage drops accordingly. White and 1/f noise are added to each current reading.
+ *
+ * Each operation takes a random time drawn from the latency distributions of the simulation profile. In the virtual
+ * clock mode the operations do not sleep: they only advance the internal clock, so long scans run as fast as
+ * possible while the measurement timestamps still follow the simulated timing. The internal clock is returned by
+ * GetClock, so the ramp steps and the periodic measurements are also scheduled on it. The virtual clock does not pass
+ * while the Controller is idle, so the Controller takes a periodic measurement only before each queued command.
+ */
+class SimulatedVoltageSource : public IVoltageSource, private Clock {
+public:
+    /// Physical parameters of the simulated load and noise.
+    struct Parameters {
+        Resistance LoadResistance;
+        Resistance SeriesResistance;
+        Capacitance LoadCapacitance;
+
+        /// Standard deviation of the white current noise.
+        ElectricCurrent WhiteNoise;
+
+        /// Standard deviation of the 1/f current noise.
+        ElectricCurrent FlickerNoise;
+
+        /// Breakdown starts when the absolute value of the voltage is above this value. Zero disables the breakdown.
+        ElectricPotential BreakdownVoltage;
+        Resistance BreakdownResistance;
+
+        Parameters();
+    };
+
+public:
+    SimulatedVoltageSource(const Parameters& parameters, const SimulationProfile& profile, bool virtualClock,
+                           unsigned long long seed);
+
+    /// \copydoc IVoltageSource::Set
+    virtual Value Set(const Value& value);
+
+    /// \copydoc IVoltageSource::Accuracy
+    virtual ElectricPotential Accuracy(const ElectricPotential& voltage);
+
+    /// \copydoc IVoltageSource::Measure
+    virtual Measurement Measure();
+
+    /// \copydoc IVoltageSource::Off
+    virtual void Off();
+
+    /// \copydoc IVoltageSource::GetClock
+    virtual Clock& GetClock() { return *this; }
+
+    /// Returns the current time of the simulation clock.
+    Time Now() const;
+
+    /// Let the simulated time pass. In the virtual clock mode only the internal clock is advanced.
+    void AdvanceTime(const Time& interval);
+
+private:
+    virtual int64_t ElapsedNanoseconds();
+    virtual int64_t SleepUntil(int64_t deadline, int64_t spinInterval);
+    virtual bool IsVirtual() const { return virtualClock; }
+
+    void Wait(const LatencyDistribution& latency);
+    void Evolve();
+    double LoadCurrent(double voltage) const;
+    double ComplianceVoltage(double compliance) const;
+    double Noise();
+
+private:
+    Parameters parameters;
+    SimulationProfile profile;
+    bool virtualClock;
+    std::mt19937_64 generator;
+    std::normal_distribution<double> normal;
+
+    double virtualTime;
+    double lastUpdateTime;
+    double targetVoltage, outputVoltage, compliance;
+    double pink[7];
+};
+
+} // vsc
@@ -25,9 +25,23 @@
 #include "exception.h"
 #include "date_time.h"
 #include "log.h"
+#include "EventLog.h"
+#include "LatencyHistogram.h"
+#include "Trace.h"
+
+namespace {
+const char* const LOCK_WAIT_SPAN_NAME = "ThreadSafeVoltageSource lock wait";
+}
+
+const std::vector<std::string>& vsc::ThreadSafeVoltageSource::ConfigSchema()
+{
+    static const std::vector<std::string> schema = { "EventSource" };
+    return schema;
+}
 
 vsc::ThreadSafeVoltageSource::ThreadSafeVoltageSource(IVoltageSource* aVoltageSource, bool _saveMeasurements)
-    : voltageSource(aVoltageSource), saveMeasurements(_saveMeasurements), isOn(false)
+    : voltageSource(aVoltageSource), saveMeasurements(_saveMeasurements), isOn(false),
+      rampSpinInterval(0.0 * vsc::seconds), eventSource(0), inCompliance(false), clock(*this)
 {
     if(!aVoltageSource)
         THROW_VSC_EXCEPTION("Ivalid parameters", "Voltage source can't be null.");
@@ -35,7 +49,10 @@ vsc::ThreadSafeVoltageSource::ThreadSafeVoltageSource(IVoltageSource* aVoltageSo
 
 vsc::IVoltageSource::Value vsc::ThreadSafeVoltageSource::Set(const Value& value)
 {
-    const std::lock_guard<std::recursive_mutex> lock(mutex);
+    static LatencyHistogram& latency = LatencyRegistry::Singleton().Get("ThreadSafeVoltageSource Set");
+    const ScopedLatency scopedLatency(latency);
+    const TraceSpan span("Set");
+    const TracedLock<std::recursive_mutex> lock(mutex, LOCK_WAIT_SPAN_NAME);
     if(!isOn || currentValue != value) {
         currentValue = voltageSource->Set(value);
         isOn = true;
@@ -45,19 +62,45 @@ vsc::IVoltageSource::Value vsc::ThreadSafeVoltageSource::Set(const Value& value)
 
 vsc::ElectricPotential vsc::ThreadSafeVoltageSource::Accuracy(const vsc::ElectricPotential& voltage)
 {
-    const std::lock_guard<std::recursive_mutex> lock(mutex);
+    const TracedLock<std::recursive_mutex> lock(mutex, LOCK_WAIT_SPAN_NAME);
     return voltageSource->Accuracy(voltage);
 }
 
 vsc::IVoltageSource::Measurement vsc::ThreadSafeVoltageSource::Measure()
 {
-    const std::lock_guard<std::recursive_mutex> lock(mutex);
+    static LatencyHistogram& latency = LatencyRegistry::Singleton().Get("ThreadSafeVoltageSource Measure");
+    const ScopedLatency scopedLatency(latency);
+    const TraceSpan span("Measure");
+    const TracedLock<std::recursive_mutex> lock(mutex, LOCK_WAIT_SPAN_NAME);
     const IVoltageSource::Measurement measurement = voltageSource->Measure();
+    Publish(measurement);
+    return measurement;
+}
+
+void vsc::ThreadSafeVoltageSource::MeasureBatch(size_t n, Measurement* out)
+{
+    static LatencyHistogram& latency = LatencyRegistry::Singleton().Get("ThreadSafeVoltageSource MeasureBatch");
+    const ScopedLatency scopedLatency(latency);
+    const TraceSpan span("MeasureBatch");
+    const TracedLock<std::recursive_mutex> lock(mutex, LOCK_WAIT_SPAN_NAME);
+    voltageSource->MeasureBatch(n, out);
+    for(size_t k = 0; k < n; ++k)
+        Publish(out[k]);
+}
+
+void vsc::ThreadSafeVoltageSource::Publish(const Measurement& measurement)
+{
+    EventLog::Singleton().Measurement(measurement, eventSource);
+    if(measurement.Compliance != inCompliance) {
+        inCompliance = measurement.Compliance;
+        EventLog::Singleton().Compliance(inCompliance, eventSource);
+    }
     if(saveMeasurements)
         measurements.push_back(measurement);
+    if(measurementRing)
+        measurementRing->Publish(measurement);
     if(onMeasurement)
         onMeasurement(measurement);
-    return measurement;
 }
 
 bool vsc::ThreadSafeVoltageSource::GradualSet(const Value& value, const vsc::ElectricPotential& step,
@@ -70,7 +113,13 @@ bool vsc::ThreadSafeVoltageSource::GradualSet(const Value& value, const vsc::Ele
         THROW_VSC_EXCEPTION("Invalid parameters", "Invalid delay between the voltage switch = " << delayBetweenSteps
                             << ". The delay should be positive or zero.");
 
-    const std::lock_guard<std::recursive_mutex> lock(mutex);
+    static LatencyHistogram& latency = LatencyRegistry::Singleton().Get("ThreadSafeVoltageSource GradualSet");
+    const ScopedLatency scopedLatency(latency);
+    const TraceSpan span("GradualSet");
+    const TracedLock<std::recursive_mutex> lock(mutex, LOCK_WAIT_SPAN_NAME);
+    vsc::PeriodicDeadline deadline(rampSpinInterval, voltageSource->GetClock());
+    deadline.Start();
+    bool inCompliance = false;
     for(bool makeNextStep = true; makeNextStep;) {
         const vsc::ElectricPotential deltaV = value.Voltage - currentValue.Voltage;
         const vsc::ElectricPotential absDeltaV = vsc::abs(deltaV);
@@ -84,29 +133,76 @@ bool vsc::ThreadSafeVoltageSource::GradualSet(const Value& value, const vsc::Ele
             voltageToSet = currentValue.Voltage + (deltaV > 0.0 * vsc::volts ? step : -step);
         }
 
+        TraceSpan stepSpan("Ramp step");
+        if(stepSpan.IsActive()) {
+            std::ostringstream detail;
+            detail << static_cast<double>(voltageToSet / vsc::volts) << " V";
+            stepSpan.SetDetail(detail.str());
+        }
         Set(Value(voltageToSet, value.Compliance));
-        vsc::Sleep(delayBetweenSteps);
+        deadline.Wait(delayBetweenSteps);
 
         if(checkForCompliance) {
             const Measurement measurement = Measure();
-            if(measurement.Compliance)
-                return false;
+            if(measurement.Compliance) {
+                inCompliance = true;
+                break;
+            }
         }
     }
-    return true;
+
+    lastRampTiming = deadline.Statistics();
+    if(lastRampTiming.Count)
+        vsc::LogDebug() << "Ramp of " << lastRampTiming.Count << " steps: mean deadline overshoot = "
+                        << lastRampTiming.Mean() << ", max overshoot = " << lastRampTiming.Maximum() << ".\n";
+    return !inCompliance;
 }
 
 void vsc::ThreadSafeVoltageSource::Off()
 {
-    const std::lock_guard<std::recursive_mutex> lock(mutex);
+    static LatencyHistogram& latency = LatencyRegistry::Singleton().Get("ThreadSafeVoltageSource Off");
+    const ScopedLatency scopedLatency(latency);
+    const TraceSpan span("Off");
+    const TracedLock<std::recursive_mutex> lock(mutex, LOCK_WAIT_SPAN_NAME);
     voltageSource->Off();
     currentValue.Voltage = 0.0 * vsc::volts;
     isOn = false;
 }
 
+void vsc::ThreadSafeVoltageSource::SetMeasurementParameters(unsigned numberOfReadingsToAverage,
+                                                           const vsc::Time& integrationTime)
+{
+    static LatencyHistogram& latency =
+            LatencyRegistry::Singleton().Get("ThreadSafeVoltageSource SetMeasurementParameters");
+    const ScopedLatency scopedLatency(latency);
+    const TracedLock<std::recursive_mutex> lock(mutex, LOCK_WAIT_SPAN_NAME);
+    voltageSource->SetMeasurementParameters(numberOfReadingsToAverage, integrationTime);
+}
+
+int64_t vsc::ThreadSafeVoltageSource::LockedClock::ElapsedNanoseconds()
+{
+    const std::lock_guard<std::recursive_mutex> lock(owner.mutex);
+    return owner.voltageSource->GetClock().ElapsedNanoseconds();
+}
+
+int64_t vsc::ThreadSafeVoltageSource::LockedClock::SleepUntil(int64_t deadline, int64_t spinInterval)
+{
+    const std::lock_guard<std::recursive_mutex> lock(owner.mutex);
+    return owner.voltageSource->GetClock().SleepUntil(deadline, spinInterval);
+}
+
+vsc::Clock& vsc::ThreadSafeVoltageSource::GetClock()
+{
+    Clock& sourceClock = voltageSource->GetClock();
+    return sourceClock.IsVirtual() ? clock : sourceClock;
+}
+
 void vsc::ThreadSafeVoltageSource::lock()
 {
-    mutex.lock();
+    if(!mutex.try_lock()) {
+        const TraceSpan span(LOCK_WAIT_SPAN_NAME);
+        mutex.lock();
+    }
 }
 
 void vsc::ThreadSafeVoltageSource::unlock()
@@ -26,10 +26,13 @@
 #include <list>
 #include <memory>
 #include <mutex>
+#include <vector>
 #include <boost/utility.hpp>
 
 #include "units.h"
 #include "IVoltageSource.h"
+#include "date_time.h"
+#include "MeasurementRing.h"
 
 namespace vsc {
 /*!
@@ -52,6 +55,9 @@ public:
      */
     explicit ThreadSafeVoltageSource(IVoltageSource* aVoltageSource, bool saveMeasurements = true);
 
+    /// Names of the voltage source configuration parameters used by ThreadSafeVoltageSource.
+    static const std::vector<std::string>& ConfigSchema();
+
     /// \copydoc IVoltageSource::Set
     virtual Value Set(const Value& value);
 
@@ -61,10 +67,32 @@ public:
     /// \copydoc IVoltageSource::Measure
     virtual Measurement Measure();
 
+    /*!
+     * \brief Perform a series of measurements holding the lock for the whole series.
+     * \copydetails IVoltageSource::MeasureBatch
+     */
+    virtual void MeasureBatch(size_t n, Measurement* out);
+
     /// \copydoc IVoltageSource::Off
     virtual void Off();
 
-    /// Gradually change voltage with given voltage step and delay between steps.
+    /// \copydoc IVoltageSource::SetMeasurementParameters
+    virtual void SetMeasurementParameters(unsigned numberOfReadingsToAverage, const Time& integrationTime);
+
+    /*!
+     * \brief Returns the clock of the voltage source.
+     *
+     * A virtual clock is advanced by the voltage source operations, so each call to it locks the
+     * ThreadSafeVoltageSource. The steady clock is returned as is.
+     */
+    virtual Clock& GetClock();
+
+    /*!
+     * \brief Gradually change voltage with given voltage step and delay between steps.
+     *
+     * The steps are scheduled on absolute deadlines, so the time spent in Set and Measure is included into the delay
+     * and the total ramp duration does not drift. Use LastRampTiming to check the achieved timing precision.
+     */
     bool GradualSet(const Value& value, const vsc::ElectricPotential& step, const vsc::Time& delayBetweenSteps,
                     bool checkForCompliance = true);
 
@@ -88,9 +116,43 @@ public:
      */
     void unlock();
 
+    /// Set the part of each ramp step delay that is spent polling the clock instead of sleeping.
+    void SetRampSpinInterval(const Time& _rampSpinInterval) { rampSpinInterval = _rampSpinInterval; }
+
+    /// Returns the overshoot statistics of the step deadlines in the last GradualSet call.
+    /// \remarks ThreadSafeVoltageSource should be locked while accessing the statistics.
+    const OvershootStatistics& LastRampTiming() const { return lastRampTiming; }
+
     /// Set callback that will be called after each measurement operation.
     void SetOnMeasurementCallback(const OnMeasurementCallback& _onMeasurement) { onMeasurement = _onMeasurement; }
 
+    /// Publish each measurement into the shared memory ring. The ring is owned by ThreadSafeVoltageSource.
+    void SetMeasurementRing(MeasurementRingWriter* _measurementRing) { measurementRing.reset(_measurementRing); }
+
+    /// Set the source id under which the measurements are recorded into the event log.
+    void SetEventSource(uint16_t _eventSource) { eventSource = _eventSource; }
+
+    /// Returns the source id under which the measurements are recorded into the event log.
+    uint16_t EventSource() const { return eventSource; }
+
+private:
+    /// Forwards the calls to the virtual clock of the voltage source under the lock.
+    class LockedClock : public Clock {
+    public:
+        explicit LockedClock(ThreadSafeVoltageSource& _owner) : owner(_owner) {}
+        virtual int64_t ElapsedNanoseconds();
+        virtual int64_t SleepUntil(int64_t deadline, int64_t spinInterval);
+        virtual bool IsVirtual() const { return true; }
+
+    private:
+        ThreadSafeVoltageSource& owner;
+    };
+
+private:
+    /// Log, store and forward the measurement to the ring and to the callback. A change of the compliance state is
+    /// also recorded into the event log.
+    void Publish(const Measurement& measurement);
+
 private:
     std::recursive_mutex mutex;
     std::unique_ptr<IVoltageSource> voltageSource;
@@ -99,6 +161,12 @@ private:
     Value currentValue;
     bool isOn;
     OnMeasurementCallback onMeasurement;
+    std::unique_ptr<MeasurementRingWriter> measurementRing;
+    Time rampSpinInterval;
+    OvershootStatistics lastRampTiming;
+    uint16_t eventSource;
+    bool inCompliance;
+    LockedClock clock;
 };
 
 }
@@ -0,0 +1,203 @@
+/*!
+ * \file Trace.cc
+ * \brief Implementation of Tracer class.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+
+#include "Trace.h"
+#include "exception.h"
+
+namespace vsc {
+
+const size_t Tracer::MAX_DETAIL_LENGTH;
+
+namespace {
+const size_t DETAIL_WORDS = (Tracer::MAX_DETAIL_LENGTH + 1) / sizeof(uint64_t);
+
+/*!
+ * \brief Slot of the span ring buffer.
+ *
+ * The slot is guarded by a sequence number like a slot of MeasurementRing: \a sequence is odd while the slot is
+ * written and equals 2 * (n + 1) when the slot holds span n, so Export can read the buffers while they are written.
+ */
+struct SpanSlot {
+    std::atomic<uint64_t> sequence;
+    std::atomic<const char*> name;
+    std::atomic<int64_t> start;
+    std::atomic<int64_t> duration;
+    std::atomic<uint64_t> detail[DETAIL_WORDS];
+};
+
+std::string EscapeJson(const std::string& str)
+{
+    std::ostringstream ss;
+    for(char c : str) {
+        if(c == '"' || c == '\\')
+            ss << '\\' << c;
+        else if(static_cast<unsigned char>(c) < 0x20)
+            ss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+        else
+            ss << c;
+    }
+    return ss.str();
+}
+}
+
+struct Tracer::ThreadBuffer {
+    unsigned id;
+    std::string threadName;
+    std::unique_ptr<SpanSlot[]> slots;
+    uint64_t mask;
+    std::atomic<uint64_t> writeCursor;
+
+    ThreadBuffer(unsigned _id, size_t capacity)
+        : id(_id), slots(new SpanSlot[capacity]), mask(capacity - 1), writeCursor(0)
+    {
+        for(size_t n = 0; n < capacity; ++n)
+            slots[n].sequence.store(0, std::memory_order_relaxed);
+    }
+};
+
+Tracer& Tracer::Singleton()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+Tracer::Tracer()
+    : enabled(false), capacity(0)
+{
+}
+
+void Tracer::Enable(size_t spansPerThread)
+{
+    const std::lock_guard<std::mutex> lock(mutex);
+    if(IsEnabled())
+        return;
+    capacity = 1;
+    while(capacity < spansPerThread)
+        capacity *= 2;
+    enabled.store(true, std::memory_order_release);
+}
+
+namespace {
+// The buffer is created on the first recorded span, so the thread name is kept aside until then.
+thread_local Tracer::ThreadBuffer* currentThreadBuffer = nullptr;
+thread_local std::string currentThreadName;
+}
+
+Tracer::ThreadBuffer& Tracer::CurrentThreadBuffer()
+{
+    // The buffers are owned by the tracer, so the spans of the finished threads are exported as well.
+    if(!currentThreadBuffer) {
+        const std::lock_guard<std::mutex> lock(mutex);
+        buffers.emplace_back(new ThreadBuffer(static_cast<unsigned>(buffers.size() + 1), capacity));
+        currentThreadBuffer = buffers.back().get();
+        currentThreadBuffer->threadName = currentThreadName;
+    }
+    return *currentThreadBuffer;
+}
+
+void Tracer::SetThreadName(const std::string& name)
+{
+    currentThreadName = name;
+    if(currentThreadBuffer) {
+        const std::lock_guard<std::mutex> lock(mutex);
+        currentThreadBuffer->threadName = name;
+    }
+}
+
+void Tracer::Record(const char* name, int64_t start, int64_t end, const char* detail)
+{
+    ThreadBuffer& buffer = CurrentThreadBuffer();
+    uint64_t detailWords[DETAIL_WORDS];
+    std::memcpy(detailWords, detail, sizeof(detailWords));
+
+    const uint64_t n = buffer.writeCursor.load(std::memory_order_relaxed);
+    SpanSlot& slot = buffer.slots[n & buffer.mask];
+    slot.sequence.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.duration.store(end - start, std::memory_order_relaxed);
+    for(size_t k = 0; k < DETAIL_WORDS; ++k)
+        slot.detail[k].store(detailWords[k], std::memory_order_relaxed);
+    slot.sequence.store(2 * (n + 1), std::memory_order_release);
+    buffer.writeCursor.store(n + 1, std::memory_order_release);
+}
+
+void Tracer::Export(const std::string& fileName)
+{
+    std::ofstream file(fileName);
+    if(!file.is_open())
+        THROW_VSC_EXCEPTION("Write file error", "Unable to open the trace file '" << fileName << "'.");
+
+    const pid_t pid = getpid();
+    const std::lock_guard<std::mutex> lock(mutex);
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[" << std::fixed << std::setprecision(3);
+    bool first = true;
+    for(const std::unique_ptr<ThreadBuffer>& buffer : buffers) {
+        if(!buffer->threadName.empty()) {
+            file << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":"
+                 << buffer->id << ",\"args\":{\"name\":\"" << EscapeJson(buffer->threadName) << "\"}}";
+            first = false;
+        }
+
+        const uint64_t cursor = buffer->writeCursor.load(std::memory_order_acquire);
+        const uint64_t size = buffer->mask + 1;
+        for(uint64_t n = cursor > size ? cursor - size : 0; n < cursor; ++n) {
+            const SpanSlot& slot = buffer->slots[n & buffer->mask];
+            const uint64_t expectedSequence = 2 * (n + 1);
+            if(slot.sequence.load(std::memory_order_acquire) != expectedSequence)
+                continue;
+            const char* name = slot.name.load(std::memory_order_relaxed);
+            const int64_t start = slot.start.load(std::memory_order_relaxed);
+            const int64_t duration = slot.duration.load(std::memory_order_relaxed);
+            uint64_t detailWords[DETAIL_WORDS];
+            for(size_t k = 0; k < DETAIL_WORDS; ++k)
+                detailWords[k] = slot.detail[k].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if(slot.sequence.load(std::memory_order_relaxed) != expectedSequence)
+                continue;
+
+            char detail[MAX_DETAIL_LENGTH + 1];
+            std::memcpy(detail, detailWords, sizeof(detail));
+            detail[MAX_DETAIL_LENGTH] = 0;
+            file << (first ? "\n" : ",\n") << "{\"name\":\"" << EscapeJson(name) << "\",\"cat\":\"vsc\",\"ph\":\"X\","
+                 << "\"ts\":" << start / 1000.0 << ",\"dur\":" << duration / 1000.0 << ",\"pid\":" << pid
+                 << ",\"tid\":" << buffer->id;
+            if(detail[0])
+                file << ",\"args\":{\"detail\":\"" << EscapeJson(detail) << "\"}";
+            file << "}";
+            first = false;
+        }
+    }
+    file << "\n]}\n";
+    if(!file)
+        THROW_VSC_EXCEPTION("Write file error", "Unable to write the trace file '" << fileName << "'.");
+}
+
+} // vsc
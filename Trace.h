@@ -0,0 +1,156 @@
+/*!
+ * \file Trace.h
+ * \brief Definition of Tracer, TraceSpan and TracedLock classes.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <boost/utility.hpp>
+
+#include "date_time.h"
+
+namespace vsc {
+/*!
+ * \brief Records time spans of the program activity to be viewed on a timeline.
+ *
+ * Each thread writes its spans into its own ring buffer without locks; when the buffer is full, the oldest spans are
+ * overwritten. Export writes the spans that are still in the buffers as a Chrome trace-event JSON file, which can be
+ * opened in chrome://tracing or Perfetto. Nothing is recorded unless the tracer is enabled, and a disabled span costs
+ * a single relaxed load.
+ */
+class Tracer : private boost::noncopyable {
+public:
+    /// Maximal number of characters in the span detail. Longer details are truncated.
+    static const size_t MAX_DETAIL_LENGTH = 23;
+
+    static Tracer& Singleton();
+
+    /*!
+     * \brief Start recording the spans.
+     * \param spansPerThread - number of the latest spans kept for each thread.
+     *
+     * Should be called before the threads that record spans are started. Subsequent calls have no effect.
+     */
+    void Enable(size_t spansPerThread);
+
+    /// Indicates if the spans are recorded.
+    bool IsEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    /// Set the name of the current thread that is shown on the timeline. Can be called before Enable.
+    void SetThreadName(const std::string& name);
+
+    /// Record a span of the current thread. \a name should be a string literal.
+    void Record(const char* name, int64_t start, int64_t end, const char* detail);
+
+    /*!
+     * \brief Write all recorded spans into the file in the Chrome trace-event format.
+     * \throw vsc::exception if the file can't be written.
+     */
+    void Export(const std::string& fileName);
+
+    struct ThreadBuffer;
+
+private:
+    Tracer();
+    ThreadBuffer& CurrentThreadBuffer();
+
+private:
+    std::atomic<bool> enabled;
+    size_t capacity;
+    std::mutex mutex;
+    std::list<std::unique_ptr<ThreadBuffer>> buffers;
+};
+
+/// Records the time between its construction and destruction as a span of the current thread.
+class TraceSpan : private boost::noncopyable {
+public:
+    /// \a name should be a string literal.
+    explicit TraceSpan(const char* _name)
+        : name(Tracer::Singleton().IsEnabled() ? _name : nullptr),
+          start(name ? DateTimeProvider::ElapsedNanoseconds() : 0)
+    {
+        detail[0] = 0;
+    }
+
+    TraceSpan(const char* _name, const std::string& _detail)
+        : TraceSpan(_name)
+    {
+        SetDetail(_detail);
+    }
+
+    ~TraceSpan()
+    {
+        if(name)
+            Tracer::Singleton().Record(name, start, DateTimeProvider::ElapsedNanoseconds(), detail);
+    }
+
+    /// Indicates if the span is recorded. Use it to avoid formatting a detail that will not be used.
+    bool IsActive() const { return name != nullptr; }
+
+    /// Set a short text shown with the span, e.g. a device command.
+    void SetDetail(const std::string& _detail)
+    {
+        if(!name)
+            return;
+        const size_t length = std::min(_detail.size(), Tracer::MAX_DETAIL_LENGTH);
+        std::memcpy(detail, _detail.data(), length);
+        detail[length] = 0;
+    }
+
+private:
+    const char* name;
+    int64_t start;
+    char detail[Tracer::MAX_DETAIL_LENGTH + 1];
+};
+
+/*!
+ * \brief Locks a mutex for its lifetime like std::lock_guard.
+ *
+ * If the mutex is already locked by another thread, the wait is recorded as a span named \a waitSpanName.
+ */
+template<typename Mutex>
+class TracedLock : private boost::noncopyable {
+public:
+    TracedLock(Mutex& _mutex, const char* waitSpanName)
+        : mutex(_mutex)
+    {
+        if(!mutex.try_lock()) {
+            const TraceSpan span(waitSpanName);
+            mutex.lock();
+        }
+    }
+
+    ~TracedLock() { mutex.unlock(); }
+
+private:
+    Mutex& mutex;
+};
+
+} // vsc
@@ -0,0 +1,448 @@
+/*!
+ * \file VoltageSourceBenchmark.cpp
+ * \brief Benchmarks of the driver, parser, logger and controller hot paths.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Usage: VoltageSourceBenchmark [-o output_file] [name_filter]
+ *
+ * Only the benchmarks whose name contains name_filter are run. The results are written as a JSON object with one
+ * entry per benchmark: number of iterations, mean, p50, p90, p99 and maximal latency of one operation in
+ * nanoseconds, throughput in operations per second and the number of heap allocations per operation. The operation
+ * of the measure_batch benchmarks is one MeasureBatch call of MEASURE_BATCH_SIZE measurements.
+ *
+ * The drivers are measured against emulated instruments: the Keithley 6487 driver talks to an emulator on a
+ * pseudo-terminal, and all drivers are also measured with the timing profiles of the simulator in the virtual clock
+ * mode. The Keithley 237 has no GPIB emulator, so its hot path is covered by the simulator profile and by the
+ * parser benchmarks, which are available if the program is built with GPIB_SUPPORT.
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "Controller.h"
+#include "LatencyHistogram.h"
+#include "Keithley6487.h"
+#include "SimulatedVoltageSource.h"
+#include "ThreadSafeVoltageSource.h"
+#include "date_time.h"
+#include "exception.h"
+#include "log.h"
+
+#ifdef GPIB_SUPPORT
+#include "Keithley237Internals.h"
+#endif
+
+namespace {
+std::atomic<uint64_t> numberOfAllocations(0);
+
+// All replaceable allocation functions go through these two, so the pairs of new and delete stay consistent. They
+// are not inlined: otherwise GCC sees std::free called on a pointer returned by operator new and reports a mismatch.
+__attribute__((noinline)) void* Allocate(std::size_t size) noexcept
+{
+    numberOfAllocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+__attribute__((noinline)) void Deallocate(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+}
+
+void* operator new(std::size_t size)
+{
+    if(void* pointer = Allocate(size))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    if(void* pointer = Allocate(size))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return Allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return Allocate(size); }
+
+void operator delete(void* pointer) noexcept { Deallocate(pointer); }
+void operator delete[](void* pointer) noexcept { Deallocate(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { Deallocate(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { Deallocate(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { Deallocate(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { Deallocate(pointer); }
+
+namespace {
+const size_t DRIVER_ITERATIONS = 20000;
+const size_t SERIAL_ITERATIONS = 2000;
+const size_t PARSER_ITERATIONS = 200000;
+const size_t LOG_ITERATIONS = 200000;
+const size_t CONTROLLER_ITERATIONS = 20000;
+const size_t MEASURE_BATCH_SIZE = 100;
+const std::string LOG_FILE_NAME = "VoltageSourceBenchmark.log";
+const std::string MEASURE_BATCH_SUFFIX = ".measure_batch" + std::to_string(MEASURE_BATCH_SIZE);
+
+void PrintUsage()
+{
+    std::cerr << "Usage: VoltageSourceBenchmark [-o output_file] [name_filter]" << std::endl;
+}
+
+struct BenchmarkResult {
+    std::string Name;
+    size_t Iterations;
+    vsc::LatencySummary Latency;
+    double Throughput;
+    double AllocationsPerOperation;
+};
+
+/*!
+ * \brief Runs the benchmarks and collects their results.
+ *
+ * Each operation is timed separately and recorded into a LatencyHistogram, which does not allocate, so the number of
+ * allocations counted during the run belongs to the measured code only. A tenth of the iterations is run before the
+ * measurement to warm up the caches and the lazily initialized statics.
+ */
+class BenchmarkRunner {
+public:
+    explicit BenchmarkRunner(const std::string& _filter) : filter(_filter) {}
+
+    bool IsSelected(const std::string& name) const { return name.find(filter) != std::string::npos; }
+
+    /*!
+     * \brief Run the benchmark if it is selected.
+     * \param finish - called after the last operation; its time is included into the throughput but not into the
+     *                 latency of the operations.
+     */
+    template<typename Operation>
+    void Run(const std::string& name, size_t iterations, Operation operation,
+             const std::function<void ()>& finish = std::function<void ()>())
+    {
+        if(!IsSelected(name))
+            return;
+        std::cerr << "Running " << name << "..." << std::endl;
+        for(size_t n = 0; n < iterations / 10; ++n)
+            operation(n);
+        if(finish)
+            finish();
+
+        vsc::LatencyHistogram histogram;
+        const uint64_t allocationsAtStart = numberOfAllocations.load(std::memory_order_relaxed);
+        const int64_t startTime = vsc::DateTimeProvider::ElapsedNanoseconds();
+        for(size_t n = 0; n < iterations; ++n) {
+            const int64_t operationStart = vsc::DateTimeProvider::ElapsedNanoseconds();
+            operation(n);
+            histogram.Record(vsc::DateTimeProvider::ElapsedNanoseconds() - operationStart);
+        }
+        if(finish)
+            finish();
+        const int64_t totalTime = vsc::DateTimeProvider::ElapsedNanoseconds() - startTime;
+        const uint64_t allocations = numberOfAllocations.load(std::memory_order_relaxed) - allocationsAtStart;
+
+        BenchmarkResult result;
+        result.Name = name;
+        result.Iterations = iterations;
+        result.Latency = histogram.Summary();
+        result.Throughput = totalTime > 0 ? iterations * 1e9 / totalTime : 0;
+        result.AllocationsPerOperation = static_cast<double>(allocations) / iterations;
+        results.push_back(result);
+    }
+
+    void WriteJson(std::ostream& s) const
+    {
+        s << "{\"benchmarks\":[";
+        for(size_t n = 0; n < results.size(); ++n) {
+            const BenchmarkResult& r = results[n];
+            s << (n ? ",\n" : "\n") << "{\"name\":\"" << r.Name << "\",\"iterations\":" << r.Iterations
+              << ",\"mean_ns\":" << r.Latency.Mean << ",\"p50_ns\":" << r.Latency.Median
+              << ",\"p90_ns\":" << r.Latency.P90 << ",\"p99_ns\":" << r.Latency.P99 << ",\"max_ns\":"
+              << r.Latency.Max << ",\"throughput_per_s\":" << static_cast<int64_t>(r.Throughput)
+              << ",\"allocations_per_op\":" << r.AllocationsPerOperation << "}";
+        }
+        s << "\n]}\n";
+    }
+
+private:
+    std::string filter;
+    std::vector<BenchmarkResult> results;
+};
+
+/*!
+ * \brief Emulates a Keithley 6487 on the master side of a pseudo-terminal.
+ *
+ * It answers only the queries that the driver sends: identification, operation complete, reading and the trace
+ * buffer queries. The trace buffer is filled immediately with the number of readings set by the trigger count. All
+ * other commands are accepted silently.
+ */
+class Keithley6487Emulator {
+public:
+    Keithley6487Emulator() : canRun(true), triggerCount(1)
+    {
+        master = posix_openpt(O_RDWR | O_NOCTTY);
+        if(master < 0 || grantpt(master) || unlockpt(master))
+            THROW_VSC_EXCEPTION("Emulator error", "Unable to create a pseudo-terminal.");
+        deviceName = ptsname(master);
+
+        // The slave side stays open, so the master does not see a hang up when the driver closes its port.
+        slave = open(deviceName.c_str(), O_RDWR | O_NOCTTY);
+        if(slave < 0)
+            THROW_VSC_EXCEPTION("Emulator error", "Unable to open '" << deviceName << "'.");
+        termios options;
+        tcgetattr(slave, &options);
+        cfmakeraw(&options);
+        tcsetattr(slave, TCSANOW, &options);
+
+        thread = std::thread(&Keithley6487Emulator::Run, this);
+    }
+
+    ~Keithley6487Emulator()
+    {
+        canRun = false;
+        thread.join();
+        close(slave);
+        close(master);
+    }
+
+    const std::string& DeviceName() const { return deviceName; }
+
+private:
+    void Run()
+    {
+        std::string line;
+        char buffer[256];
+        while(canRun) {
+            pollfd descriptor = { master, POLLIN, 0 };
+            if(poll(&descriptor, 1, 50) <= 0)
+                continue;
+            const ssize_t size = read(master, buffer, sizeof(buffer));
+            if(size <= 0)
+                continue;
+            for(ssize_t n = 0; n < size; ++n) {
+                if(buffer[n] == '\n') {
+                    Reply(line);
+                    line.clear();
+                } else if(buffer[n] != '\r')
+                    line += buffer[n];
+            }
+        }
+    }
+
+    void Reply(const std::string& command)
+    {
+        static const std::string IDENTIFICATION = "KEITHLEY INSTRUMENTS INC.,MODEL 6487,1234567,A01\n";
+        static const std::string OPERATION_COMPLETE = "1\n";
+        static const std::string READING = "-1.234567E-09,+1.000000E+02";
+        static const std::string TRIGGER_COUNT = "TRIG:COUN ";
+
+        if(command == "*IDN?")
+            Write(IDENTIFICATION);
+        else if(command == "*OPC?")
+            Write(OPERATION_COMPLETE);
+        else if(command == "READ?")
+            Write(READING + "\n");
+        else if(command.compare(0, TRIGGER_COUNT.size(), TRIGGER_COUNT) == 0)
+            triggerCount = std::stoul(command.substr(TRIGGER_COUNT.size()));
+        else if(command == "TRAC:POIN:ACT?")
+            Write(std::to_string(triggerCount) + "\n");
+        else if(command == "TRAC:DATA?") {
+            std::string trace;
+            for(size_t n = 0; n < triggerCount; ++n)
+                trace += (n ? "," : "") + READING;
+            Write(trace + "\n");
+        }
+    }
+
+    void Write(const std::string& reply)
+    {
+        for(size_t written = 0; written < reply.size();) {
+            const ssize_t size = write(master, reply.data() + written, reply.size() - written);
+            if(size < 0)
+                return;
+            written += size;
+        }
+    }
+
+private:
+    int master, slave;
+    std::string deviceName;
+    std::atomic<bool> canRun;
+    size_t triggerCount;
+    std::thread thread;
+};
+
+vsc::IVoltageSource::Value SetValue(size_t n)
+{
+    // Alternate the voltage, so the drivers can't skip the Set as a repeated one.
+    return vsc::IVoltageSource::Value((n % 2 ? 20.0 : 10.0) * vsc::volts, 1e-6 * vsc::amperes);
+}
+
+void RunDriverBenchmarks(BenchmarkRunner& runner, const std::string& name, vsc::IVoltageSource* driver,
+                         size_t iterations)
+{
+    vsc::ThreadSafeVoltageSource voltageSource(driver, false);
+    runner.Run(name + ".set", iterations, [&](size_t n) { voltageSource.Set(SetValue(n)); });
+    runner.Run(name + ".measure", iterations, [&](size_t) { voltageSource.Measure(); });
+
+    std::vector<vsc::IVoltageSource::Measurement> batch(MEASURE_BATCH_SIZE);
+    runner.Run(name + MEASURE_BATCH_SUFFIX, iterations / 10,
+               [&](size_t) { voltageSource.MeasureBatch(batch.size(), batch.data()); });
+}
+
+bool IsAnyDriverBenchmarkSelected(const BenchmarkRunner& runner, const std::string& name)
+{
+    return runner.IsSelected(name + ".set") || runner.IsSelected(name + ".measure")
+            || runner.IsSelected(name + MEASURE_BATCH_SUFFIX);
+}
+
+void RunSimulatorBenchmarks(BenchmarkRunner& runner)
+{
+    static const std::vector<std::string> profiles = { "Ideal", "Keithley237", "Keithley6487" };
+    for(const std::string& profile : profiles) {
+        RunDriverBenchmarks(runner, "simulator." + profile, new vsc::SimulatedVoltageSource(
+                                vsc::SimulatedVoltageSource::Parameters(), vsc::SimulationProfile::Get(profile),
+                                true, 1), DRIVER_ITERATIONS);
+    }
+}
+
+void RunEmulatorBenchmarks(BenchmarkRunner& runner)
+{
+    static const std::string name = "keithley6487.emulator";
+    if(!IsAnyDriverBenchmarkSelected(runner, name))
+        return;
+    Keithley6487Emulator emulator;
+    RunDriverBenchmarks(runner, name, new vsc::Keithley6487(emulator.DeviceName()), SERIAL_ITERATIONS);
+}
+
+template<typename Value>
+void RunParserBenchmark(BenchmarkRunner& runner, const std::string& name, const std::string& reply)
+{
+    runner.Run(name, PARSER_ITERATIONS, [&](size_t) {
+        std::stringstream ss;
+        ss << reply;
+        Value value;
+        ss >> value;
+    });
+}
+
+void RunParserBenchmarks(BenchmarkRunner& runner)
+{
+    // The driver parses each reply from a fresh stringstream, so its construction is included.
+    RunParserBenchmark<vsc::Keithley6487::Measurement>(runner, "parser.keithley6487.measurement",
+                                                       "-1.234567E-09,+1.000000E+02");
+#ifdef GPIB_SUPPORT
+    RunParserBenchmark<vsc::Keithley237Internals::Measurement>(runner, "parser.keithley237.measurement",
+                                                               "NSDCV+100.000E+00,NMDCI+1.23456E-09");
+    RunParserBenchmark<vsc::Keithley237Internals::ErrorStatus>(runner, "parser.keithley237.error_status",
+                                                               "ERS00000000000000000000000000");
+    RunParserBenchmark<vsc::Keithley237Internals::MachineStatus>(runner, "parser.keithley237.machine_status",
+                                                                 "MSTG01,0,0K0M000,0N1R1T4,0,0,0V1Y0");
+#endif
+}
+
+void RunLogBenchmarks(BenchmarkRunner& runner)
+{
+    if(!runner.IsSelected("log.sync") && !runner.IsSelected("log.async"))
+        return;
+    vsc::LogDebug().open(LOG_FILE_NAME);
+    const auto logMessage = [](size_t n) {
+        vsc::LogDebug("Benchmark") << "Measurement " << n << ": I = " << 1.234567e-9 << " A, V = " << 100.0 << " V."
+                                   << std::endl;
+    };
+    runner.Run("log.sync", LOG_ITERATIONS, logMessage);
+
+    if(!runner.IsSelected("log.async"))
+        return;
+    vsc::log::AsyncLogWriter::Singleton().Start(1 << 16, 1.0 * vsc::seconds, false);
+    runner.Run("log.async", LOG_ITERATIONS, logMessage, [] { vsc::log::AsyncLogWriter::Singleton().Flush(); });
+    vsc::log::AsyncLogWriter::Singleton().Stop();
+}
+
+void RunControllerBenchmarks(BenchmarkRunner& runner)
+{
+    static const std::string name = "controller.dispatch";
+    if(!runner.IsSelected(name))
+        return;
+
+    // Disconnect without a connected voltage source does nothing but call back, so only the dispatch is measured.
+    vsc::Controller controller;
+    std::atomic<bool> done(false);
+    controller.AddOnDisconnectSuccessfulCallback([&] { done.store(true, std::memory_order_release); });
+    std::thread thread(std::ref(controller));
+    runner.Run(name, CONTROLLER_ITERATIONS, [&](size_t) {
+        done.store(false, std::memory_order_relaxed);
+        controller.SendCommand(vsc::Controller::Command::Disconnect);
+        while(!done.load(std::memory_order_acquire))
+            std::this_thread::yield();
+    });
+    controller.SendCommand(vsc::Controller::Command::Exit);
+    thread.join();
+}
+}
+
+int main(int argc, char *argv[])
+{
+    std::string outputFileName, filter;
+    for(int n = 1; n < argc; ++n) {
+        const std::string argument = argv[n];
+        if(argument == "-o" && n + 1 < argc)
+            outputFileName = argv[++n];
+        else if(argument[0] != '-' && filter.empty())
+            filter = argument;
+        else {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    try {
+        BenchmarkRunner runner(filter);
+        RunSimulatorBenchmarks(runner);
+        RunEmulatorBenchmarks(runner);
+        RunParserBenchmarks(runner);
+        RunControllerBenchmarks(runner);
+        // The logger goes last: once the debug log is opened, the benchmarks above would also write into it.
+        RunLogBenchmarks(runner);
+
+        if(outputFileName.empty())
+            runner.WriteJson(std::cout);
+        else {
+            std::ofstream outputFile(outputFileName);
+            if(!outputFile.is_open())
+                THROW_VSC_EXCEPTION("Write file error", "Unable to open the output file '" << outputFileName << "'.");
+            runner.WriteJson(outputFile);
+        }
+    } catch(vsc::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
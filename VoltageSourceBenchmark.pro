@@ -0,0 +1,71 @@
+#-------------------------------------------------
+#
+# Benchmarks of the driver, parser, logger and controller hot paths.
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+TARGET = VoltageSourceBenchmark
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+QMAKE_CXXFLAGS = -std=c++11 -O2
+
+# Uncomment to enable the Keithley 237 parser benchmarks (requires linux-gpib).
+#DEFINES += GPIB_SUPPORT
+#LIBS += -lgpib
+
+LIBS += -lboost_system -lboost_date_time -ldl -lrt -lpthread
+
+# Driver plugins loaded with dlopen use the symbols of the program.
+QMAKE_LFLAGS += -rdynamic
+
+SOURCES += VoltageSourceBenchmark.cpp \
+    Controller.cc \
+    GpibStream.cc \
+    Keithley237.cc \
+    Keithley237Internals.cc \
+    Keithley6487.cc \
+    serialstream.cc \
+    ThreadSafeVoltageSource.cc \
+    date_time.cc \
+    log.cc \
+    VoltageSourceFactory.cc \
+    BaseConfig.cc \
+    EventLog.cc \
+    DeviceDiscovery.cc \
+    DriverRegistry.cc \
+    SimulatedVoltageSource.cc \
+    ReplayVoltageSource.cc \
+    FaultInjection.cc \
+    MeasurementRing.cc \
+    LatencyHistogram.cc \
+    Trace.cc
+
+HEADERS += Controller.h \
+    FakeVoltageSource.h \
+    GpibStream.h \
+    IVoltageSource.h \
+    Keithley237.h \
+    Keithley237Internals.h \
+    Keithley6487.h \
+    serialstream.h \
+    ThreadSafeVoltageSource.h \
+    units.h \
+    date_time.h \
+    exception.h \
+    log.h \
+    VoltageSourceFactory.h \
+    ConfigParameters.h \
+    BaseConfig.h \
+    MpscQueue.h \
+    EventLog.h \
+    DeviceDiscovery.h \
+    DriverRegistry.h \
+    SimulatedVoltageSource.h \
+    ReplayVoltageSource.h \
+    FaultInjection.h \
+    MeasurementRing.h \
+    LatencyHistogram.h \
+    Trace.h
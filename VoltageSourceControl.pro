@@ -14,7 +14,17 @@ TARGET = VoltageSourceControl
 TEMPLATE = app
 QMAKE_CXXFLAGS = -std=c++11
 
-LIBS += -lboost_system -lboost_date_time
+# Logs below this level are compiled out: 0 - Debug, 1 - Info, 2 - Error.
+#DEFINES += VSC_MIN_LOG_LEVEL=1
+
+# Uncomment to enable the Keithley 237 driver and GPIB device discovery (requires linux-gpib).
+#DEFINES += GPIB_SUPPORT
+#LIBS += -lgpib
+
+LIBS += -lboost_system -lboost_date_time -ldl -lrt
+
+# Driver plugins loaded with dlopen use the symbols of the program.
+QMAKE_LFLAGS += -rdynamic
 
 SOURCES += main.cpp\
         MainWindow.cpp \
@@ -29,7 +39,20 @@ SOURCES += main.cpp\
     VoltageSourceFactory.cc \
     BaseConfig.cc \
     Controller.cc \
-    GuiController.cpp
+    GuiController.cpp \
+    EventLog.cc \
+    FileWatcher.cc \
+    DeviceDiscovery.cc \
+    DriverRegistry.cc \
+    SimulatedVoltageSource.cc \
+    ReplayVoltageSource.cc \
+    FaultInjection.cc \
+    MeasurementSeries.cc \
+    MeasurementPlot.cpp \
+    MeasurementBridge.cc \
+    MeasurementRing.cc \
+    LatencyHistogram.cc \
+    Trace.cc
 
 HEADERS  += MainWindow.h \
     FakeVoltageSource.h \
@@ -48,7 +71,21 @@ HEADERS  += MainWindow.h \
     ConfigParameters.h \
     BaseConfig.h \
     Controller.h \
-    GuiController.h
+    GuiController.h \
+    MpscQueue.h \
+    EventLog.h \
+    FileWatcher.h \
+    DeviceDiscovery.h \
+    DriverRegistry.h \
+    SimulatedVoltageSource.h \
+    ReplayVoltageSource.h \
+    FaultInjection.h \
+    MeasurementSeries.h \
+    MeasurementPlot.h \
+    MeasurementBridge.h \
+    MeasurementRing.h \
+    LatencyHistogram.h \
+    Trace.h
 
 FORMS    += MainWindow.ui
 
@@ -0,0 +1,183 @@
+/*!
+ * \file VoltageSourceDaemon.cpp
+ * \brief Headless voltage source controller.
+ * \author Konstantin Androsov (INFN Pisa, Siena University)
+ * \date 2026-10-18 created
+ *
+ * Copyright 2026 Konstantin Androsov <konstantin.androsov@gmail.com>
+ *
+ * This file is part of VoltageSourceControl.
+ *
+ * VoltageSourceControl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltageSourceControl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Usage: VoltageSourceDaemon [config_directory]
+ *
+ * Runs the controller without GUI. The measurements are journaled into the event log, and the controller is operated
+ * through the control socket (see ControlServer). If MetricsPort is not zero, the metrics are served in the Prometheus
+ * format on that port of the loopback interface (see MetricsServer).
+ *
+ * SIGHUP reloads the configuration file, SIGUSR1 writes the latency histograms into the info log, SIGUSR2 exports
+ * the trace (if Tracing is enabled), SIGINT and SIGTERM disconnect from the voltage source and stop the daemon.
+ */
+
+#include <csignal>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "exception.h"
+#include "ConfigParameters.h"
+#include "Controller.h"
+#include "ControlServer.h"
+#include "EventLog.h"
+#include "FileWatcher.h"
+#include "LatencyHistogram.h"
+#include "log.h"
+#include "MetricsServer.h"
+#include "Trace.h"
+
+namespace {
+const std::string LOG_HEAD = "daemon";
+
+void PrintUsage()
+{
+    std::cerr << "Usage: VoltageSourceDaemon [config_directory]" << std::endl;
+}
+}
+
+int main(int argc, char *argv[])
+{
+    if(argc > 2) {
+        PrintUsage();
+        return 1;
+    }
+
+    // Signals are handled by sigwait in the main thread, so they should be blocked before any thread is started.
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGHUP);
+    sigaddset(&signals, SIGUSR1);
+    sigaddset(&signals, SIGUSR2);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    try {
+        const std::string directory = argc == 2 ? argv[1] : ".";
+        ConfigParameters::Update([&](ConfigParameters& configParameters) { configParameters.setDirectory(directory); });
+        ConfigParameters::Reload();
+        const ConfigParameters::Pointer configParameters = ConfigParameters::Singleton();
+        vsc::LogDebug().open(configParameters->FullDebugFileName());
+        vsc::LogError().open(configParameters->FullErrorFileName());
+        vsc::LogInfo().open(configParameters->FullLogFileName());
+        vsc::LogInfo(LOG_HEAD) << "Starting... " << vsc::LogInfo::FullTimestampString() << std::endl;
+        if(configParameters->EventLogging())
+            vsc::EventLog::Singleton().Open(configParameters->FullEventLogFileName());
+    } catch(vsc::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    const ConfigParameters::Pointer configParameters = ConfigParameters::Singleton();
+    vsc::LogDebug::SetEnabled(configParameters->DebugLogging());
+    if(configParameters->AsynchronousLogging())
+        vsc::log::AsyncLogWriter::Singleton().Start(configParameters->LogFlushSize(),
+                                                    configParameters->LogFlushInterval());
+    if(configParameters->Tracing())
+        vsc::Tracer::Singleton().Enable(configParameters->TraceBufferSize());
+    vsc::Tracer::Singleton().SetThreadName("Main");
+
+    vsc::Controller controller;
+    controller.AddOnConnectSuccessfulCallback([]() {
+        vsc::LogInfo(LOG_HEAD) << "Connected to the voltage source.\n";
+    });
+    controller.AddOnDisconnectSuccessfulCallback([]() {
+        vsc::LogInfo(LOG_HEAD) << "Disconnected from the voltage source.\n";
+    });
+    const auto reportError = [](const vsc::exception& e) {
+        vsc::LogError(e.header()) << "ERROR: " << e.message() << std::endl;
+    };
+    controller.AddOnConnectFailedCallback(reportError);
+    controller.AddOnDisconnectFailedCallback(reportError);
+    controller.AddOnErrorCallback(reportError);
+    const auto exportTrace = [&configParameters, &reportError]() {
+        if(!vsc::Tracer::Singleton().IsEnabled())
+            return;
+        try {
+            vsc::Tracer::Singleton().Export(configParameters->FullTraceFileName());
+            vsc::LogInfo(LOG_HEAD) << "Trace exported to '" << configParameters->FullTraceFileName() << "'.\n";
+        } catch(vsc::exception& e) {
+            reportError(e);
+        }
+    };
+    std::thread controllerThread(std::bind(&vsc::Controller::operator(), &controller));
+
+    const auto requestShutdown = []() { kill(getpid(), SIGTERM); };
+    std::unique_ptr<vsc::ControlServer> controlServer;
+    std::unique_ptr<vsc::MetricsServer> metricsServer;
+    std::unique_ptr<vsc::FileWatcher> configWatcher;
+    try {
+        controlServer.reset(new vsc::ControlServer(controller, configParameters->FullControlSocketFileName(),
+                                                   requestShutdown));
+        if(configParameters->MetricsPort())
+            metricsServer.reset(new vsc::MetricsServer(controller, configParameters->MetricsPort()));
+        if(configParameters->ReloadOnConfigFileChange()) {
+            configWatcher.reset(new vsc::FileWatcher(configParameters->FullConfigFileName(), [&controller]() {
+                ConfigParameters::Reload();
+                vsc::LogInfo(LOG_HEAD) << "Configuration reloaded.\n";
+                controller.SendCommand(vsc::Controller::Command::ApplyConfiguration);
+            }));
+        }
+        if(configParameters->DaemonConnectOnStart())
+            controller.SendCommand(vsc::Controller::Command::Connect);
+
+        for(;;) {
+            int signal = 0;
+            sigwait(&signals, &signal);
+            if(signal == SIGUSR1) {
+                std::ostringstream report;
+                vsc::LatencyRegistry::Singleton().Report(report);
+                vsc::LogInfo(LOG_HEAD) << "Latency histograms:\n" << report.str();
+                continue;
+            }
+            if(signal == SIGUSR2) {
+                exportTrace();
+                continue;
+            }
+            if(signal != SIGHUP)
+                break;
+            ConfigParameters::Reload();
+            vsc::LogInfo(LOG_HEAD) << "Configuration reloaded.\n";
+            controller.SendCommand(vsc::Controller::Command::ApplyConfiguration);
+        }
+    } catch(vsc::exception& e) {
+        reportError(e);
+    }
+
+    configWatcher.reset();
+    controller.SendCommand(vsc::Controller::Command::Disconnect);
+    controller.SendCommand(vsc::Controller::Command::Exit);
+    controllerThread.join();
+    controlServer.reset();
+    metricsServer.reset();
+    exportTrace();
+
+    vsc::LogInfo(LOG_HEAD) << "Exiting... " << vsc::LogInfo::FullTimestampString() << std::endl;
+    vsc::log::AsyncLogWriter::Singleton().Stop();
+    vsc::EventLog::Singleton().Close();
+    return 0;
+}
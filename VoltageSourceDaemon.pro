@@ -0,0 +1,86 @@
+#-------------------------------------------------
+#
+# Headless voltage source controller.
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+TARGET = VoltageSourceDaemon
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+QMAKE_CXXFLAGS = -std=c++11
+
+# Logs below this level are compiled out: 0 - Debug, 1 - Info, 2 - Error.
+#DEFINES += VSC_MIN_LOG_LEVEL=1
+
+# Uncomment to enable the Keithley 237 driver and GPIB device discovery (requires linux-gpib).
+#DEFINES += GPIB_SUPPORT
+#LIBS += -lgpib
+
+LIBS += -lboost_system -lboost_date_time -ldl -lrt -lpthread
+
+# Driver plugins loaded with dlopen use the symbols of the program.
+QMAKE_LFLAGS += -rdynamic
+
+SOURCES += VoltageSourceDaemon.cpp \
+    ControlServer.cc \
+    Controller.cc \
+    GpibStream.cc \
+    Keithley237.cc \
+    Keithley237Internals.cc \
+    Keithley6487.cc \
+    serialstream.cc \
+    ThreadSafeVoltageSource.cc \
+    date_time.cc \
+    log.cc \
+    VoltageSourceFactory.cc \
+    BaseConfig.cc \
+    EventLog.cc \
+    FileWatcher.cc \
+    DeviceDiscovery.cc \
+    DriverRegistry.cc \
+    SimulatedVoltageSource.cc \
+    ReplayVoltageSource.cc \
+    FaultInjection.cc \
+    MeasurementBridge.cc \
+    MeasurementRing.cc \
+    LatencyHistogram.cc \
+    Trace.cc \
+    MetricsServer.cc
+
+HEADERS += ControlServer.h \
+    ControlProtocol.h \
+    Controller.h \
+    FakeVoltageSource.h \
+    GpibStream.h \
+    IVoltageSource.h \
+    Keithley237.h \
+    Keithley237Internals.h \
+    Keithley6487.h \
+    serialstream.h \
+    ThreadSafeVoltageSource.h \
+    units.h \
+    date_time.h \
+    exception.h \
+    log.h \
+    VoltageSourceFactory.h \
+    ConfigParameters.h \
+    BaseConfig.h \
+    MpscQueue.h \
+    EventLog.h \
+    FileWatcher.h \
+    DeviceDiscovery.h \
+    DriverRegistry.h \
+    SimulatedVoltageSource.h \
+    ReplayVoltageSource.h \
+    FaultInjection.h \
+    MeasurementBridge.h \
+    MeasurementRing.h \
+    LatencyHistogram.h \
+    Trace.h \
+    MetricsServer.h
+
+OTHER_FILES += \
+    parameters.cfg
@@ -21,61 +21,111 @@
  * along with VoltageSourceControl.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <map>
+#include <algorithm>
+#include <future>
+#include <limits>
 
 #include "ConfigParameters.h"
-#include "Keithley237.h"
-#include "Keithley6487.h"
+#include "DriverRegistry.h"
 #include "VoltageSourceFactory.h"
 #include "FakeVoltageSource.h"
+#include "FaultInjection.h"
 
-typedef vsc::IVoltageSource* (*Maker)(const ConfigParameters&);
-typedef std::map<std::string, Maker> MakerMap;
-
-//static vsc::IVoltageSource* Keithley237Maker(const ConfigParameters& configParameters)
-//{
-//    const vsc::Keithley237::Configuration keithleyConfig(configParameters.VoltageSourceDevice(),
-//            configParameters.SetVoltageSourceToLocalModeOnExit(),
-//            configParameters.NumberOfVoltageSourceReadingsToAverage(),
-//            configParameters.VoltageSourceIntegrationTime());
-//    return new vsc::Keithley237(keithleyConfig);
-//}
-
-static vsc::IVoltageSource* FakeVoltageSourceMaker(const ConfigParameters&)
+static vsc::IVoltageSource* FakeVoltageSourceMaker(const VoltageSourceConfig&)
 {
     return new vsc::FakeVoltageSource(100.0 * vsc::mega * vsc::ohms, 5.0 * vsc::seconds, false, true, false);
 }
 
-static MakerMap CreateMakerMap()
+VSC_REGISTER_DRIVER(Fake, &FakeVoltageSourceMaker, vsc::DriverCapability::Simulation);
+
+/// Parameters used by the factory itself and by the Controller.
+static const std::vector<std::string> FACTORY_CONFIG_PARAMETERS = { "Driver", "MeasurementInterval" };
+
+static bool IsUsed(const std::string& parameterName, const std::vector<std::string>& schema)
 {
-    MakerMap map;
-//    map["Keithley237"] = &Keithley237Maker;
-    map["Fake"] = &FakeVoltageSourceMaker;
-    return map;
+    return std::find(schema.begin(), schema.end(), parameterName) != schema.end();
 }
 
-static const MakerMap makerMap = CreateMakerMap();
+static vsc::IVoltageSource* CreateVoltageSource(const VoltageSourceConfig& config)
+{
+    const vsc::DriverInfo& driver = vsc::DriverRegistry::Singleton().Get(config.Driver(),
+                                    ConfigParameters::Singleton()->FullDriverPluginDirectory());
+    if(config.EventSource() > std::numeric_limits<uint16_t>::max())
+        THROW_VSC_EXCEPTION("Configuration error", "Event source id " << config.EventSource() << " of '"
+                            << config.Name() << "' is out of range.");
+    for(const std::string& parameterName : config.FileParameterNames()) {
+        if(!IsUsed(parameterName, FACTORY_CONFIG_PARAMETERS) && !IsUsed(parameterName, driver.ConfigSchema)
+                && !IsUsed(parameterName, vsc::ThreadSafeVoltageSource::ConfigSchema())
+                && !IsUsed(parameterName, vsc::FaultInjectingVoltageSource::ConfigSchema())
+                && !IsUsed(parameterName, vsc::MeasurementRingWriter::ConfigSchema()))
+            vsc::LogInfo(config.Name()) << "Warning: Parameter '" << parameterName << "' is not used by the driver '"
+                                        << driver.Name << "'.\n";
+    }
+    if(config.Faults().empty())
+        return driver.maker(config);
+
+    const vsc::FaultSchedule schedule(config.Faults(), config.FaultSeed());
+    vsc::FaultInjectingVoltageSource::Settings settings;
+    settings.LatencySpike = config.FaultLatencySpike();
+    settings.Timeout = config.FaultTimeout();
+    settings.ReconnectTime = config.FaultReconnectTime();
+    vsc::LogInfo(config.Name()) << "Warning: Failures are injected with the schedule '" << config.Faults() << "'.\n";
+    return new vsc::FaultInjectingVoltageSource(driver.maker(config), schedule, settings);
+}
 
-static vsc::IVoltageSource* CreateVoltageSource()
+vsc::VoltageSourceFactory::Pointer vsc::VoltageSourceFactory::Create(const VoltageSourceConfig& config)
 {
-    const ConfigParameters& configParameters = ConfigParameters::Singleton();
-    MakerMap::const_iterator iter = makerMap.find(configParameters.VoltageSource());
-    if(iter == makerMap.end())
-        THROW_VSC_EXCEPTION("Configuration error", "Voltage source '" << configParameters.VoltageSource()
-                            << "' not found.");
-    return iter->second(configParameters);
+    Pointer voltageSource(new ThreadSafeVoltageSource(CreateVoltageSource(config)));
+    voltageSource->SetRampSpinInterval(ConfigParameters::Singleton()->RampSpinInterval());
+    voltageSource->SetEventSource(static_cast<uint16_t>(config.EventSource()));
+    if(!config.MeasurementRing().empty())
+        voltageSource->SetMeasurementRing(new MeasurementRingWriter(config.MeasurementRing(),
+                                                                    config.MeasurementRingCapacity()));
+    return voltageSource;
 }
 
 vsc::VoltageSourceFactory::Pointer vsc::VoltageSourceFactory::Create()
 {
-    return Pointer(new ThreadSafeVoltageSource(CreateVoltageSource()));
+    return Create(*ConfigParameters::Singleton()->ControllerVoltageSource());
 }
 
-const vsc::VoltageSourceFactory::NameSet& vsc::VoltageSourceFactory::GetNames()
+vsc::VoltageSourceFactory::Pointer vsc::VoltageSourceFactory::Create(const DiscoveredDevice& device)
 {
-    static NameSet voltageSources;
-    if(!voltageSources.size()) {
-        voltageSources.insert("Fake");
+    if(device.Driver.empty())
+        THROW_VSC_EXCEPTION("Configuration error", "Instrument '" << device.Identification << "' on "
+                            << device.Address << " is not supported.");
+    const std::shared_ptr<VoltageSourceConfig> config = ConfigParameters::Singleton()->DefaultVoltageSource();
+    config->setDriver(device.Driver);
+    config->setDevice(device.Address);
+    return Create(*config);
+}
+
+vsc::VoltageSourceFactory::PointerMap vsc::VoltageSourceFactory::CreateAll()
+{
+    typedef std::shared_ptr<VoltageSourceConfig> ConfigPtr;
+    const std::vector<ConfigPtr> configs = ConfigParameters::Singleton()->VoltageSources();
+
+    std::vector<std::future<Pointer>> futures;
+    for(const ConfigPtr& config : configs)
+        futures.push_back(std::async(std::launch::async, [config]() { return Create(*config); }));
+
+    PointerMap voltageSources;
+    std::ostringstream errors;
+    for(size_t n = 0; n < configs.size(); ++n) {
+        try {
+            voltageSources[configs[n]->Name()] = futures[n].get();
+        } catch(vsc::exception& e) {
+            errors << "\n" << configs[n]->Name() << ": " << e.message();
+        }
     }
+    if(!errors.str().empty())
+        THROW_VSC_EXCEPTION("Connection error", "Unable to create voltage sources:" << errors.str());
+    return voltageSources;
+}
+
+const vsc::VoltageSourceFactory::NameSet& vsc::VoltageSourceFactory::GetNames()
+{
+    static const NameSet voltageSources =
+            DriverRegistry::Singleton().GetNames(ConfigParameters::Singleton()->FullDriverPluginDirectory());
     return voltageSources;
 }
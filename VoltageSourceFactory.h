@@ -24,15 +24,41 @@
 #pragma once
 
 #include <set>
+#include <map>
 #include <memory>
 #include "ThreadSafeVoltageSource.h"
+#include "DeviceDiscovery.h"
+
+class VoltageSourceConfig;
 
 namespace vsc {
 class VoltageSourceFactory {
 public:
     typedef std::shared_ptr<ThreadSafeVoltageSource> Pointer;
     typedef std::set<std::string> NameSet;
+    typedef std::map<std::string, Pointer> PointerMap;
+
+    /// Create the voltage source operated by the Controller (see ConfigParameters::ControllerVoltageSource).
     static Pointer Create();
+
+    /// Create the voltage source with the given configuration.
+    static Pointer Create(const VoltageSourceConfig& config);
+
+    /*!
+     * \brief Create the voltage source for an instrument found by DeviceDiscovery.
+     * \throw vsc::exception if the instrument is not supported or can't be initialized.
+     *
+     * The measurement parameters are taken from the VoltageSource* configuration parameters.
+     */
+    static Pointer Create(const DiscoveredDevice& device);
+
+    /*!
+     * \brief Create all voltage sources defined in the configuration file, indexed by their names.
+     * \throw vsc::exception if any of the voltage sources can't be created. Already created sources are destroyed.
+     *
+     * The voltage sources are connected concurrently, so the slow device initializations do not add up.
+     */
+    static PointerMap CreateAll();
     static const NameSet& GetNames();
 
 private:
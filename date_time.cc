@@ -22,6 +22,12 @@
  */
 
 #include <thread>
+#include <chrono>
+#include <ctime>
+#include <limits>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
 #include <boost/date_time.hpp>
 
 #include "date_time.h"
@@ -32,38 +38,225 @@ boost::posix_time::ptime _Now()
     return boost::date_time::microsec_clock<boost::posix_time::ptime>::universal_time();
 }
 
+/*!
+ * \brief Per-thread cache of the formatted current time.
+ *
+ * The wall-clock time is computed as a wall-clock anchor plus the steady clock time passed since the anchor was taken,
+ * and the anchor is refreshed once per second. The date and time up to seconds are formatted only when the second
+ * changes; for all other calls only the six sub-second digits are written.
+ */
+class TimestampCache {
+public:
+    /// Length of "YYYY-MM-DDTHH:MM:SS".
+    static const size_t PrefixLength = 19;
+
+    /// Position of "HH:MM:SS" inside the prefix.
+    static const size_t TimeOfDayPosition = 11;
+
+    /// Length of "YYYY-MM-DDTHH:MM:SS.ffffff".
+    static const size_t Length = PrefixLength + 7;
+
+    TimestampCache() : cachedSecond(std::numeric_limits<int64_t>::min()), anchorWallTime(0), isAnchored(false)
+    {
+        buffer[Length] = 0;
+    }
+
+    /// Returns "YYYY-MM-DDTHH:MM:SS.ffffff" for the current time.
+    const char* Update()
+    {
+        const int64_t wallTime = WallTimeNow();
+        const int64_t second = wallTime >= 0 ? wallTime / 1000000000 : (wallTime + 1) / 1000000000 - 1;
+        if(second != cachedSecond) {
+            const std::time_t t = static_cast<std::time_t>(second);
+            std::tm tm;
+            gmtime_r(&t, &tm);
+            std::strftime(buffer, PrefixLength + 1, "%Y-%m-%dT%H:%M:%S", &tm);
+            buffer[PrefixLength] = '.';
+            cachedSecond = second;
+        }
+        unsigned microseconds = static_cast<unsigned>((wallTime - second * 1000000000) / 1000);
+        for(size_t n = Length - 1; n > PrefixLength; --n) {
+            buffer[n] = static_cast<char>('0' + microseconds % 10);
+            microseconds /= 10;
+        }
+        return buffer;
+    }
+
+private:
+    int64_t WallTimeNow()
+    {
+        typedef std::chrono::steady_clock SteadyClock;
+        static const SteadyClock::duration anchorLifetime = std::chrono::seconds(1);
+        const SteadyClock::time_point now = SteadyClock::now();
+        if(!isAnchored || now - anchorSteadyTime >= anchorLifetime) {
+            anchorWallTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::system_clock::now().time_since_epoch()).count();
+            anchorSteadyTime = SteadyClock::now();
+            isAnchored = true;
+            return anchorWallTime;
+        }
+        return anchorWallTime + std::chrono::duration_cast<std::chrono::nanoseconds>(now - anchorSteadyTime).count();
+    }
+
+private:
+    int64_t cachedSecond;
+    char buffer[Length + 1];
+    std::chrono::steady_clock::time_point anchorSteadyTime;
+    int64_t anchorWallTime;
+    bool isAnchored;
+};
+
+TimestampCache& ThreadTimestampCache()
+{
+    static thread_local TimestampCache cache;
+    return cache;
+}
+
+typedef std::chrono::steady_clock SteadyClock;
+
+/// The program start time, measured on both wall and steady clocks.
+struct StartPoint {
+    boost::posix_time::ptime wallTime;
+    SteadyClock::time_point steadyTime;
+
+    StartPoint() : wallTime(_Now()), steadyTime(SteadyClock::now()) {}
+};
+
+const StartPoint& _StartPoint()
+{
+    static const StartPoint startPoint;
+    return startPoint;
+}
+
 const boost::posix_time::ptime& _StartTime()
 {
-    static boost::posix_time::ptime startTime = _Now();
-    return startTime;
+    return _StartPoint().wallTime;
+}
+
+int64_t WallClockNanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
 }
+
+/// Offset between the wall clock and the elapsed time in nanoseconds.
+std::atomic<int64_t> wallClockOffset(std::numeric_limits<int64_t>::min());
 }
 
 namespace vsc {
 
-std::chrono::microseconds TimeToChronoDuration(const Time& time)
+int64_t TimeToNanoseconds(const Time& time)
 {
-    static const Time time_factor = 1.0 * micro * seconds;
-    const double delay_in_micro_seconds = time / time_factor;
-    return std::chrono::microseconds(static_cast<int64_t>(delay_in_micro_seconds));
+    static const Time time_factor = 1.0 * nano * seconds;
+    return static_cast<int64_t>(std::llround(time / time_factor));
 }
 
 void Sleep(const Time& time)
 {
-    const std::chrono::microseconds delay = TimeToChronoDuration(time);
-    std::this_thread::sleep_for(delay);
+    std::this_thread::sleep_for(std::chrono::nanoseconds(TimeToNanoseconds(time)));
+}
+
+int64_t SleepUntil(int64_t deadline, int64_t spinInterval)
+{
+    const SteadyClock::time_point start = _StartPoint().steadyTime;
+    const int64_t sleepDeadline = deadline - spinInterval;
+    if(DateTimeProvider::ElapsedNanoseconds() < sleepDeadline)
+        std::this_thread::sleep_until(start + std::chrono::nanoseconds(sleepDeadline));
+    int64_t now = DateTimeProvider::ElapsedNanoseconds();
+    while(now < deadline)
+        now = DateTimeProvider::ElapsedNanoseconds();
+    return now - deadline;
+}
+
+namespace {
+class SteadyTimeClock : public Clock {
+public:
+    virtual int64_t ElapsedNanoseconds() { return DateTimeProvider::ElapsedNanoseconds(); }
+    virtual int64_t SleepUntil(int64_t deadline, int64_t spinInterval)
+    {
+        return vsc::SleepUntil(deadline, spinInterval);
+    }
+};
+}
+
+Clock& Clock::Steady()
+{
+    static SteadyTimeClock clock;
+    return clock;
+}
+
+void OvershootStatistics::Add(int64_t overshoot)
+{
+    ++Count;
+    Total += overshoot;
+    Max = std::max(Max, overshoot);
+}
+
+Time OvershootStatistics::Mean() const
+{
+    return Count ? static_cast<double>(Total) / Count * nano * seconds : 0.0 * seconds;
+}
+
+Time OvershootStatistics::Maximum() const
+{
+    return static_cast<double>(Max) * nano * seconds;
+}
+
+PeriodicDeadline::PeriodicDeadline(const Time& _spinInterval, Clock& _clock)
+    : clock(_clock), spinInterval(TimeToNanoseconds(_spinInterval)), deadline(clock.ElapsedNanoseconds())
+{
+}
+
+void PeriodicDeadline::Start()
+{
+    deadline = clock.ElapsedNanoseconds();
+    statistics = OvershootStatistics();
+}
+
+Time PeriodicDeadline::Wait(const Time& period)
+{
+    const int64_t periodInNanoseconds = TimeToNanoseconds(period);
+    deadline += periodInNanoseconds;
+    const int64_t missed = clock.ElapsedNanoseconds() - deadline;
+    if(missed > 0)
+        deadline += missed + periodInNanoseconds;
+    const int64_t overshoot = std::max<int64_t>(missed, 0) + clock.SleepUntil(deadline, spinInterval);
+    statistics.Add(overshoot);
+    return static_cast<double>(overshoot) * nano * seconds;
 }
 
 std::string DateTimeProvider::Now()
 {
-    const boost::posix_time::ptime now = _Now();
-    return boost::posix_time::to_iso_extended_string(now);
+    return std::string(ThreadTimestampCache().Update(), TimestampCache::Length);
 }
 
 std::string DateTimeProvider::TimeNow()
 {
-    const boost::posix_time::ptime now = _Now();
-    return boost::posix_time::to_simple_string(now.time_of_day());
+    const char* timestamp = ThreadTimestampCache().Update();
+    return std::string(timestamp + TimestampCache::TimeOfDayPosition,
+                       TimestampCache::Length - TimestampCache::TimeOfDayPosition);
+}
+
+std::string DateTimeProvider::DecoratedNow()
+{
+    std::string result;
+    result.reserve(TimestampCache::Length + 2);
+    result += '<';
+    result.append(ThreadTimestampCache().Update(), TimestampCache::Length);
+    result += '>';
+    return result;
+}
+
+std::string DateTimeProvider::DecoratedTimeNow()
+{
+    const char* timestamp = ThreadTimestampCache().Update();
+    std::string result;
+    result.reserve(TimestampCache::Length - TimestampCache::TimeOfDayPosition + 2);
+    result += '<';
+    result.append(timestamp + TimestampCache::TimeOfDayPosition,
+                  TimestampCache::Length - TimestampCache::TimeOfDayPosition);
+    result += '>';
+    return result;
 }
 
 std::string DateTimeProvider::StartTime()
@@ -72,10 +265,39 @@ std::string DateTimeProvider::StartTime()
     return boost::posix_time::to_iso_extended_string(startTime);
 }
 
+int64_t DateTimeProvider::ElapsedNanoseconds()
+{
+    const SteadyClock::duration deltaT = SteadyClock::now() - _StartPoint().steadyTime;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(deltaT).count();
+}
+
 Time DateTimeProvider::ElapsedTime()
 {
-    const boost::posix_time::time_duration deltaT = _Now() - _StartTime();
-    return deltaT.total_microseconds() * vsc::micro * vsc::seconds;
+    return static_cast<double>(ElapsedNanoseconds()) * vsc::nano * vsc::seconds;
+}
+
+void DateTimeProvider::CalibrateWallClock()
+{
+    static const size_t numberOfProbes = 5;
+    int64_t bestOffset = 0, bestUncertainty = std::numeric_limits<int64_t>::max();
+    for(size_t n = 0; n < numberOfProbes; ++n) {
+        const int64_t before = ElapsedNanoseconds();
+        const int64_t wallTime = WallClockNanoseconds();
+        const int64_t after = ElapsedNanoseconds();
+        if(after - before < bestUncertainty) {
+            bestUncertainty = after - before;
+            bestOffset = wallTime - (before + after) / 2;
+        }
+    }
+    wallClockOffset = bestOffset;
+}
+
+int64_t DateTimeProvider::ToWallTime(const Time& elapsedTime)
+{
+    if(wallClockOffset == std::numeric_limits<int64_t>::min())
+        CalibrateWallClock();
+    const int64_t elapsedNanoseconds = static_cast<int64_t>(elapsedTime / (1.0 * vsc::nano * vsc::seconds));
+    return elapsedNanoseconds + wallClockOffset;
 }
 
 }
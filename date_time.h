@@ -23,6 +23,8 @@
 
 #pragma once
 
+#include <cstdint>
+#include <string>
 #include <boost/date_time/posix_time/posix_time_duration.hpp>
 
 #include "units.h"
@@ -30,10 +32,123 @@
 namespace vsc {
 extern void Sleep(const Time& time);
 
+/*!
+ * \brief Sleep until the given deadline on the DateTimeProvider::ElapsedNanoseconds time scale.
+ * \param deadline - the deadline in nanoseconds since the program start.
+ * \param spinInterval - the last part of the wait that is spent polling the clock instead of sleeping.
+ * \return the time in nanoseconds by which the wake-up was later than the deadline.
+ */
+extern int64_t SleepUntil(int64_t deadline, int64_t spinInterval = 0);
+
+/*!
+ * \brief Time scale on which the waits of a voltage source are scheduled.
+ *
+ * The steady clock of the program is used by default. A simulated voltage source can provide a virtual clock that is
+ * advanced instead of sleeping, so the ramps and the periodic measurements run as fast as possible while keeping the
+ * simulated timing.
+ */
+class Clock {
+public:
+    virtual ~Clock() {}
+
+    /// Returns the time in nanoseconds since the program start.
+    virtual int64_t ElapsedNanoseconds() = 0;
+
+    /// Wait until the deadline in nanoseconds. Returns the time by which the wake-up was later than the deadline.
+    virtual int64_t SleepUntil(int64_t deadline, int64_t spinInterval) = 0;
+
+    /// Indicates if the clock is not related to the real time, i.e. the waits on it take no real time.
+    virtual bool IsVirtual() const { return false; }
+
+    /// Returns the steady clock of the program (see DateTimeProvider::ElapsedNanoseconds).
+    static Clock& Steady();
+};
+
+/// Statistics of the deadline overshoots collected by PeriodicDeadline.
+struct OvershootStatistics {
+    size_t Count;
+    int64_t Total;
+    int64_t Max;
+
+    OvershootStatistics() : Count(0), Total(0), Max(0) {}
+
+    void Add(int64_t overshoot);
+    Time Mean() const;
+    Time Maximum() const;
+};
+
+/*!
+ * \brief Sleeps for a sequence of periods measured from a fixed start time.
+ *
+ * Each deadline is the previous deadline plus the period, not the previous wake-up time plus the period, so the
+ * scheduler latency of one step does not shift the following ones and the total duration of N steps stays N periods.
+ * If the deadline has already passed when Wait is called, e.g. because the step took longer than the period, the
+ * schedule is restarted from now, so the wait still lasts the full period and the following waits do not return
+ * immediately trying to catch up.
+ * If \a spinInterval is not zero, the last part of each wait is done by polling the steady clock, which reduces the
+ * overshoot from the scheduler granularity to a few microseconds at the cost of the CPU time. The deadlines are
+ * measured on \a clock, so the waits on a virtual clock take no real time.
+ */
+class PeriodicDeadline {
+public:
+    explicit PeriodicDeadline(const Time& spinInterval = 0.0 * seconds, Clock& clock = Clock::Steady());
+
+    /// Set the reference time to now and reset the statistics.
+    void Start();
+
+    /// Advance the deadline by \a period and sleep until it. Returns the overshoot including the missed time.
+    Time Wait(const Time& period);
+
+    /// Returns the overshoot statistics since Start.
+    const OvershootStatistics& Statistics() const { return statistics; }
+
+private:
+    Clock& clock;
+    int64_t spinInterval;
+    int64_t deadline;
+    OvershootStatistics statistics;
+};
+
+/*!
+ * \brief Provides the current date and time.
+ *
+ * Now and TimeNow are cheap enough to be called for each log message: the wall-clock time is derived from the steady
+ * clock and only the sub-second digits are reformatted while the second does not change.
+ */
 struct DateTimeProvider {
+    /// Returns the current UTC date and time as "YYYY-MM-DDTHH:MM:SS.ffffff".
     static std::string Now();
+
+    /// Returns the current UTC time as "HH:MM:SS.ffffff".
     static std::string TimeNow();
+
+    /// Returns Now() enclosed in angle brackets.
+    static std::string DecoratedNow();
+
+    /// Returns TimeNow() enclosed in angle brackets.
+    static std::string DecoratedTimeNow();
+
     static std::string StartTime();
+
+    /// Returns the steady (monotonic) time in nanoseconds since the program start.
+    static int64_t ElapsedNanoseconds();
+
+    /*!
+     * \brief Returns the steady (monotonic) time since the program start.
+     *
+     * It is not affected by the wall-clock adjustments and should be used for all measurement timestamps.
+     */
     static Time ElapsedTime();
+
+    /*!
+     * \brief Measure the current offset between the wall clock and the steady clock.
+     *
+     * Call it periodically to follow the wall-clock adjustments in ToWallTime. The first calibration is done
+     * automatically.
+     */
+    static void CalibrateWallClock();
+
+    /// Convert a time returned by ElapsedTime into the wall-clock time in nanoseconds since the Unix epoch.
+    static int64_t ToWallTime(const Time& elapsedTime);
 };
 }
@@ -4,43 +4,46 @@
  */
 
 #include <iostream>
-#include <fstream>
+#include <exception>
+#include <csignal>
+#include <cerrno>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include "log.h"
 
-typedef std::map<vsc::colors::Color, std::string> ColorMap;
-
-static ColorMap MakeColorMap()
-{
-    using namespace vsc::colors;
-    ColorMap m;
-    m[Default] = "\033[0m";
-    m[Black] = "\033[30m";
-    m[BlackB] = "\033[1;30m";
-    m[Red] = "\033[31m";
-    m[RedB] = "\033[1;31m";
-    m[Green] = "\033[32m";
-    m[GreenB] = "\033[1;32m";
-    m[Yellow] = "\033[33m";
-    m[YellowB] = "\033[1;33m";
-    m[Blue] = "\033[34m";
-    m[BlueB] = "\033[1;34m";
-    m[Pink] = "\033[35m";
-    m[PinkB] = "\033[1;35m";
-    m[Cyan] = "\033[36m";
-    m[CyanB] = "\033[1;36m";
-    m[White] = "\033[37m";
-    m[WhiteB] = "\033[1;37m";
-    return m;
-}
-
-std::string vsc::log::detail::ConsoleCommand::MakeString(const colors::Color& c)
-{
-    static const ColorMap map = MakeColorMap();
-    ColorMap::const_iterator iter = map.find(c);
-    if(iter != map.end())
-        return iter->second;
-    return "";
+namespace {
+/// Terminal escape sequences indexed by vsc::colors::Color.
+const char* const COLOR_CODES[] = {
+    "\033[0m",
+    "\033[30m", "\033[31m", "\033[32m", "\033[33m", "\033[34m", "\033[35m", "\033[36m", "\033[37m",
+    "\033[1;30m", "\033[1;31m", "\033[1;32m", "\033[1;33m", "\033[1;34m", "\033[1;35m", "\033[1;36m",
+    "\033[1;37m"
+};
+
+/// The log file data is written when the buffer reaches this size or when the log is flushed.
+const size_t LOG_BUFFER_SIZE = 1 << 16;
+}
+
+void vsc::log::detail::WriteAll(int fd, const std::string& str)
+{
+    for(size_t written = 0; written < str.size();) {
+        const ssize_t size = ::write(fd, str.data() + written, str.size() - written);
+        if(size < 0) {
+            if(errno == EINTR)
+                continue;
+            return;
+        }
+        written += static_cast<size_t>(size);
+    }
+}
+
+const char* vsc::log::detail::ConsoleCommand::Code(const colors::Color& c)
+{
+    static const size_t numberOfColors = sizeof(COLOR_CODES) / sizeof(COLOR_CODES[0]);
+    const size_t index = static_cast<size_t>(c);
+    return index < numberOfColors ? COLOR_CODES[index] : "";
 }
 
 void vsc::log::detail::ConsoleWriter::Write_cout(const std::string& str)
@@ -53,15 +56,256 @@ void vsc::log::detail::ConsoleWriter::Write_cerr(const std::string& str)
     std::cerr << str;
 }
 
+void vsc::log::detail::ConsoleWriter::EmergencyWrite_cout(const std::string& str)
+{
+    WriteAll(STDOUT_FILENO, str);
+}
+
+void vsc::log::detail::ConsoleWriter::EmergencyWrite_cerr(const std::string& str)
+{
+    WriteAll(STDERR_FILENO, str);
+}
+
+vsc::log::detail::LogBaseImpl::~LogBaseImpl()
+{
+    flush();
+    if(fd >= 0)
+        ::close(fd);
+}
+
 void vsc::log::detail::LogBaseImpl::open(const std::string& fileName)
 {
-    file = boost::shared_ptr<std::ostream>(new std::ofstream(fileName.c_str()));
+    flush();
+    if(fd >= 0)
+        ::close(fd);
+    fd = ::open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+}
+
+void vsc::log::detail::LogBaseImpl::write(const std::string& logString, bool flush)
+{
+    if(fd < 0)
+        return;
+    buffer += logString;
+    if(flush || buffer.size() >= LOG_BUFFER_SIZE)
+        this->flush();
+}
+
+void vsc::log::detail::LogBaseImpl::flush()
+{
+    if(fd < 0 || buffer.empty())
+        return;
+    WriteAll(fd, buffer);
+    buffer.clear();
+}
+
+void vsc::log::detail::LogBaseImpl::emergency_write(const std::string& logString)
+{
+    if(fd < 0)
+        return;
+    flush();
+    WriteAll(fd, logString);
+}
+
+std::atomic<bool> vsc::log::detail::asyncWriterIsRunning(false);
+
+void vsc::log::detail::PushToAsyncWriter(LogRecord&& record)
+{
+    AsyncLogWriter::Singleton().Push(std::move(record));
+}
+
+namespace {
+// SIGTERM is a request to stop, not a crash: the programs handle it themselves and stop the writer normally.
+const int FATAL_SIGNALS[] = { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT };
+
+/// Number of 1 ms polls the crash handler waits for the writer thread to leave the queue and the files.
+const unsigned EMERGENCY_WAIT_POLLS = 2000;
+std::terminate_handler previousTerminateHandler = nullptr;
+}
+
+vsc::log::AsyncLogWriter& vsc::log::AsyncLogWriter::Singleton()
+{
+    // Log singletons should be created before the writer to be destroyed after it.
+    detail::LogBase<detail::Debug>::Singleton();
+    detail::LogBase<detail::Info>::Singleton();
+    detail::LogBase<detail::Error>::Singleton();
+    static AsyncLogWriter writer;
+    return writer;
+}
+
+vsc::log::AsyncLogWriter::AsyncLogWriter()
+    : writerIsSleeping(false), stopRequested(false), flushRequested(false), emergencyRequested(false),
+      writerIsBusy(false), flushCount(0), flushSize(0), flushInterval(0)
+{}
+
+vsc::log::AsyncLogWriter::~AsyncLogWriter()
+{
+    Stop();
+}
+
+void vsc::log::AsyncLogWriter::Start(size_t _flushSize, const Time& _flushInterval, bool installCrashHandlers)
+{
+    static const Time microsecond = 1.0 * micro * seconds;
+    if(thread.joinable())
+        return;
+    flushSize = _flushSize;
+    flushInterval = std::chrono::microseconds(static_cast<int64_t>(_flushInterval / microsecond));
+    if(flushInterval <= std::chrono::microseconds::zero())
+        flushInterval = std::chrono::milliseconds(1);
+    stopRequested = false;
+    thread = std::thread(&AsyncLogWriter::Run, this);
+    detail::asyncWriterIsRunning.store(true, std::memory_order_release);
+
+    static bool crashHandlersInstalled = false;
+    if(installCrashHandlers && !crashHandlersInstalled) {
+        previousTerminateHandler = std::set_terminate(&AsyncLogWriter::OnTerminate);
+        struct sigaction action;
+        action.sa_handler = &AsyncLogWriter::OnFatalSignal;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESETHAND;
+        for(int signal : FATAL_SIGNALS)
+            sigaction(signal, &action, nullptr);
+        crashHandlersInstalled = true;
+    }
+}
+
+void vsc::log::AsyncLogWriter::Stop()
+{
+    if(!thread.joinable())
+        return;
+    detail::asyncWriterIsRunning.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopRequested = true;
+    }
+    wakeUp.notify_one();
+    thread.join();
+
+    // Messages pushed by threads that saw the writer still running could arrive after its final drain.
+    Drain();
+    FlushFiles();
+}
+
+void vsc::log::AsyncLogWriter::Flush()
+{
+    if(!thread.joinable() || std::this_thread::get_id() == thread.get_id()) {
+        FlushFiles();
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    const unsigned long targetCount = flushCount + 1;
+    flushRequested = true;
+    wakeUp.notify_one();
+    flushed.wait(lock, [&]() { return flushCount >= targetCount; });
+}
+
+void vsc::log::AsyncLogWriter::Push(detail::LogRecord&& record)
+{
+    queue.Push(std::move(record));
+    if(writerIsSleeping) {
+        std::lock_guard<std::mutex> lock(mutex);
+        wakeUp.notify_one();
+    }
 }
 
-void vsc::log::detail::LogBaseImpl::write(const std::string& logString)
+void vsc::log::AsyncLogWriter::Run()
 {
-    if(file) {
-        (*file) << logString;
-        file->flush();
+    typedef std::chrono::steady_clock Clock;
+    size_t bytesSinceFlush = 0;
+    Clock::time_point lastFlush = Clock::now();
+    detail::LogRecord record;
+    for(;;) {
+        writerIsBusy.store(true);
+        if(emergencyRequested.load()) {
+            writerIsBusy.store(false);
+            return;
+        }
+        while(!emergencyRequested.load(std::memory_order_relaxed) && queue.Pop(record)) {
+            record.sink(record.logString, record.terminalString);
+            bytesSinceFlush += record.logString.size();
+            if(bytesSinceFlush >= flushSize) {
+                FlushFiles();
+                bytesSinceFlush = 0;
+                lastFlush = Clock::now();
+            }
+        }
+
+        const bool flushIsRequested = flushRequested.exchange(false);
+        const Clock::time_point now = Clock::now();
+        if(flushIsRequested || (bytesSinceFlush && now - lastFlush >= flushInterval)) {
+            FlushFiles();
+            bytesSinceFlush = 0;
+            lastFlush = now;
+        }
+        writerIsBusy.store(false);
+        if(flushIsRequested) {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++flushCount;
+            flushed.notify_all();
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        if(stopRequested && !queue.Size())
+            break;
+        writerIsSleeping = true;
+        if(!queue.Size() && !flushRequested && !stopRequested)
+            wakeUp.wait_for(lock, flushInterval);
+        writerIsSleeping = false;
     }
+    writerIsBusy.store(true);
+    if(!emergencyRequested.load())
+        FlushFiles();
+    writerIsBusy.store(false);
+    ++flushCount;
+    flushed.notify_all();
+}
+
+void vsc::log::AsyncLogWriter::Drain()
+{
+    detail::LogRecord record;
+    while(queue.Pop(record))
+        record.sink(record.logString, record.terminalString);
+}
+
+void vsc::log::AsyncLogWriter::FlushFiles()
+{
+    detail::LogBase<detail::Debug>::Singleton().flush();
+    detail::LogBase<detail::Info>::Singleton().flush();
+    detail::LogBase<detail::Error>::Singleton().flush();
+    std::cout.flush();
+    std::cerr.flush();
+}
+
+void vsc::log::AsyncLogWriter::EmergencyFlush()
+{
+    // Only async-signal-safe operations are allowed here: the writer thread is polled with nanosleep and the data is
+    // written with write(2). The queue nodes are only read, so nothing is allocated or freed.
+    if(!thread.joinable() || emergencyRequested.exchange(true))
+        return;
+    if(std::this_thread::get_id() != thread.get_id()) {
+        const timespec pollInterval = { 0, 1000000 };
+        for(unsigned n = 0; writerIsBusy.load() && n < EMERGENCY_WAIT_POLLS; ++n)
+            nanosleep(&pollInterval, nullptr);
+        if(writerIsBusy.load())
+            return;
+    }
+    detail::LogBase<detail::Debug>::Singleton().emergencyFlush();
+    detail::LogBase<detail::Info>::Singleton().emergencyFlush();
+    detail::LogBase<detail::Error>::Singleton().emergencyFlush();
+    queue.ForEach([](const detail::LogRecord& record) {
+        record.emergencySink(record.logString, record.terminalString);
+    });
+}
+
+void vsc::log::AsyncLogWriter::OnTerminate()
+{
+    Singleton().EmergencyFlush();
+    if(previousTerminateHandler)
+        previousTerminateHandler();
+    std::abort();
+}
+
+void vsc::log::AsyncLogWriter::OnFatalSignal(int signal)
+{
+    Singleton().EmergencyFlush();
+    std::raise(signal);
 }
@@ -16,6 +16,16 @@
  * Nothing will be dummped into file unless it is opened. File will be automatically closed
  * at the end of program.
  *
+ * A message posted into a disabled log costs only one check: nothing is formatted. LogDebug is
+ * enabled only after its file is opened. Any log can be disabled at runtime with SetEnabled(false)
+ * and at compile time by defining VSC_MIN_LOG_LEVEL (0 - Debug, 1 - Info, 2 - Error): logs below
+ * that level are compiled out. Use IsEnabled() to skip preparation of expensive message arguments.
+ *
+ * By default each message is written and flushed by the thread that posted it. After
+ * vsc::log::AsyncLogWriter::Singleton().Start() is called, messages are only queued by the posting
+ * thread and a dedicated writer thread does all console and file output, flushing files by size or
+ * by time. Queued messages are flushed on Stop(), at the end of program, or when the program crashes.
+ *
  * Examples using LogInfo. LogDebug and LogError work in the same way:
  *
  *   vsc::LogInfo().open( "info.log"); // set output filename: works only once
@@ -38,10 +48,20 @@
 #include <string>
 #include <sstream>
 #include <list>
-
+#include <atomic>
+#include <type_traits>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
 #include <mutex>
+#include <boost/shared_ptr.hpp>
 
 #include "date_time.h"
+#include "MpscQueue.h"
+
+#ifndef VSC_MIN_LOG_LEVEL
+#define VSC_MIN_LOG_LEVEL 0
+#endif
 
 namespace vsc {
 namespace colors {
@@ -63,14 +83,76 @@ class Error;
 template<typename L>
 struct LogWriter;
 
+/// Compile-time level of each log.
+template<typename L>
+struct LogLevel;
+
+template<>
+struct LogLevel<Debug> { static const int Value = 0; };
+
+template<>
+struct LogLevel<Info> { static const int Value = 1; };
+
+template<>
+struct LogLevel<Error> { static const int Value = 2; };
+
+/// Write the whole string into the file descriptor using only write(2). Async-signal-safe.
+void WriteAll(int fd, const std::string& str);
+
+/*!
+ * \brief Log file with its own output buffer.
+ *
+ * The file is written with write(2) on a descriptor that stays open until the end of program, so the crash handlers
+ * can write the buffered data without locks or allocations (see flush and emergency_write).
+ */
 class LogBaseImpl {
 public:
+    LogBaseImpl() : fd(-1) {}
+    ~LogBaseImpl();
     void open(const std::string& fileName);
-    void write(const std::string& logString);
+    void write(const std::string& logString, bool flush);
+
+    /// Write the buffered data. Async-signal-safe if no other thread uses the file.
+    void flush();
+
+    bool is_open() const { return fd >= 0; }
+
+    /// Write the buffered data followed by the string. Async-signal-safe if no other thread uses the file.
+    void emergency_write(const std::string& logString);
+
+private:
+    LogBaseImpl(const LogBaseImpl&);
+    LogBaseImpl& operator=(const LogBaseImpl&);
+
 private:
-    boost::shared_ptr<std::ostream> file;
+    int fd;
+    std::string buffer;
 };
 
+/// A message queued for the asynchronous writer.
+struct LogRecord {
+    typedef void (*Sink)(const std::string& logString, const std::string& terminalString);
+
+    /// Writes the message in the writer thread.
+    Sink sink;
+
+    /// Writes the message with write(2) only. Called from the crash handlers.
+    Sink emergencySink;
+
+    std::string logString;
+    std::string terminalString;
+
+    LogRecord() : sink(nullptr), emergencySink(nullptr) {}
+    LogRecord(Sink _sink, Sink _emergencySink, const std::string& _logString, const std::string& _terminalString)
+        : sink(_sink), emergencySink(_emergencySink), logString(_logString), terminalString(_terminalString) {}
+};
+
+/// Indicates if messages should be passed to the asynchronous writer.
+extern std::atomic<bool> asyncWriterIsRunning;
+
+/// Pass a message to the asynchronous writer.
+void PushToAsyncWriter(LogRecord&& record);
+
 template<typename L>
 class LogBase {
 public:
@@ -82,57 +164,124 @@ public:
     void open(const std::string& fileName) {
         std::lock_guard<std::mutex> lock(mutex);
         logImpl.open(fileName);
+        hasOutput.store(LogWriter<L>::HasTerminal || logImpl.is_open(), std::memory_order_relaxed);
     }
 
+    /// Indicates if a message posted into the log will be written anywhere.
+    bool IsEnabled() const {
+        return enabled.load(std::memory_order_relaxed) && hasOutput.load(std::memory_order_relaxed);
+    }
+
+    void SetEnabled(bool value) { enabled.store(value, std::memory_order_relaxed); }
+
     void write(const std::string& logString, const std::string& terminalString) {
+        if(asyncWriterIsRunning.load(std::memory_order_acquire))
+            PushToAsyncWriter(LogRecord(&LogBase<L>::AsyncSink, &LogBase<L>::EmergencySink, logString,
+                                        terminalString));
+        else
+            writeNow(logString, terminalString, true);
+    }
+
+    void writeNow(const std::string& logString, const std::string& terminalString, bool flush) {
         std::lock_guard<std::mutex> lock(mutex);
         LogWriter<L>::terminal_write(terminalString);
-        logImpl.write(logString);
-        LogWriter<L>::repeat_write(logString, terminalString);
+        logImpl.write(logString, flush);
+        LogWriter<L>::repeat_write(logString, terminalString, flush);
+    }
+
+    void flush() {
+        std::lock_guard<std::mutex> lock(mutex);
+        logImpl.flush();
+    }
+
+    /// Write the buffered data without locking. Used only by the crash handlers.
+    void emergencyFlush() { logImpl.flush(); }
+
+    /// Write the message without locking. Used only by the crash handlers.
+    void emergencyWrite(const std::string& logString, const std::string& terminalString) {
+        LogWriter<L>::terminal_emergency_write(terminalString);
+        logImpl.emergency_write(logString);
+        LogWriter<L>::repeat_emergency_write(logString);
     }
 
 private:
-    LogBase() {}
+    LogBase() : enabled(true), hasOutput(LogWriter<L>::HasTerminal) {}
+
+    static void AsyncSink(const std::string& logString, const std::string& terminalString) {
+        Singleton().writeNow(logString, terminalString, false);
+    }
+
+    static void EmergencySink(const std::string& logString, const std::string& terminalString) {
+        Singleton().emergencyWrite(logString, terminalString);
+    }
 
     LogBaseImpl logImpl;
     std::mutex mutex;
+    std::atomic<bool> enabled, hasOutput;
 };
 
 struct ConsoleCommand {
-    static std::string MakeString(const colors::Color& c);
+    static std::string MakeString(const colors::Color& c) { return Code(c); }
+    static const char* Code(const colors::Color& c);
 };
 
 class ConsoleWriter {
 protected:
     static void Write_cout(const std::string& str);
     static void Write_cerr(const std::string& str);
+    static void EmergencyWrite_cout(const std::string& str);
+    static void EmergencyWrite_cerr(const std::string& str);
 };
 
 template<>
 struct LogWriter<Debug> {
+    static const bool HasTerminal = false;
+
     static void terminal_write(const std::string&) {}
-    static void repeat_write(const std::string& /*logString*/, const std::string& /*terminalString*/) {}
+    static void repeat_write(const std::string& /*logString*/, const std::string& /*terminalString*/, bool) {}
+    static void terminal_emergency_write(const std::string&) {}
+    static void repeat_emergency_write(const std::string& /*logString*/) {}
 };
 
 template<>
 struct LogWriter<Info> : private ConsoleWriter {
+    static const bool HasTerminal = true;
+
     static void terminal_write(const std::string& str) {
         ConsoleWriter::Write_cout(str);
     }
 
-    static void repeat_write(const std::string& logString, const std::string& terminalString) {
-        LogBase<Debug>::Singleton().write(logString, terminalString);
+    static void repeat_write(const std::string& logString, const std::string& terminalString, bool flush) {
+        LogBase<Debug>::Singleton().writeNow(logString, terminalString, flush);
+    }
+
+    static void terminal_emergency_write(const std::string& str) {
+        ConsoleWriter::EmergencyWrite_cout(str);
+    }
+
+    static void repeat_emergency_write(const std::string& logString) {
+        LogBase<Debug>::Singleton().emergencyWrite(logString, std::string());
     }
 };
 
 template<>
 struct LogWriter<Error> : private ConsoleWriter {
+    static const bool HasTerminal = true;
+
     static void terminal_write(const std::string& str) {
         ConsoleWriter::Write_cerr(str);
     }
 
-    static void repeat_write(const std::string& logString, const std::string& terminalString) {
-        LogBase<Debug>::Singleton().write(logString, terminalString);
+    static void repeat_write(const std::string& logString, const std::string& terminalString, bool flush) {
+        LogBase<Debug>::Singleton().writeNow(logString, terminalString, flush);
+    }
+
+    static void terminal_emergency_write(const std::string& str) {
+        ConsoleWriter::EmergencyWrite_cerr(str);
+    }
+
+    static void repeat_emergency_write(const std::string& logString) {
+        LogBase<Debug>::Singleton().emergencyWrite(logString, std::string());
     }
 };
 
@@ -160,17 +309,59 @@ struct LogColor<Error> {
 
 template<typename L>
 class Log {
+private:
+    /// Position inside the message where a color should be switched on the terminal.
+    struct ColorMark {
+        size_t position;
+        colors::Color color;
+    };
+
+    static const size_t MaxNumberOfColorMarks = 8;
+
 public:
-    explicit Log() { (*this) << LogColor<L>::MessageColor(); }
-    explicit Log(const std::string& head) {
-        std::ostringstream ss;
-        ss << "[" << head << "] ";
-        (*this) << LogColor<L>::HeaderColor() << ss.str() << LogColor<L>::MessageColor();
+    /// Indicates if the log level is compiled in and messages posted into the log will be written anywhere.
+    static bool IsEnabled() {
+        return LogLevel<L>::Value >= VSC_MIN_LOG_LEVEL && log::detail::LogBase<L>::Singleton().IsEnabled();
+    }
+
+    /// Enable or disable the log at runtime.
+    static void SetEnabled(bool value) { log::detail::LogBase<L>::Singleton().SetEnabled(value); }
+
+    explicit Log() : enabled(IsEnabled()), numberOfColorMarks(0) {
+        if(enabled) {
+            new (&streamStorage) std::ostringstream();
+            (*this) << LogColor<L>::MessageColor();
+        }
+    }
+
+    explicit Log(const std::string& head) : enabled(IsEnabled()), numberOfColorMarks(0) {
+        if(enabled) {
+            new (&streamStorage) std::ostringstream();
+            (*this) << LogColor<L>::HeaderColor();
+            stream() << "[" << head << "] ";
+            (*this) << LogColor<L>::MessageColor();
+        }
     }
 
     ~Log() {
-        (*this) << colors::Default;
-        log::detail::LogBase<L>::Singleton().write(logStream.str(), terminalStream.str());
+        if(!enabled)
+            return;
+        const std::string logString = stream().str();
+        std::string terminalString;
+        if(LogWriter<L>::HasTerminal) {
+            terminalString.reserve(logString.size() + 8 * (numberOfColorMarks + 1));
+            size_t position = 0;
+            for(size_t n = 0; n < numberOfColorMarks; ++n) {
+                terminalString.append(logString, position, marks[n].position - position);
+                terminalString += log::detail::ConsoleCommand::Code(marks[n].color);
+                position = marks[n].position;
+            }
+            terminalString.append(logString, position, std::string::npos);
+            terminalString += log::detail::ConsoleCommand::Code(colors::Default);
+        }
+        typedef std::ostringstream Stream;
+        stream().~Stream();
+        log::detail::LogBase<L>::Singleton().write(logString, terminalString);
     }
 
     void open(const std::string& fileName) {
@@ -179,48 +370,114 @@ public:
 
     template<typename T>
     Log& operator<<(const T& t) {
-        logStream << t;
-        terminalStream << t;
+        if(enabled)
+            stream() << t;
         return *this;
     }
 
     Log& operator<<(log::detail::ostream_manipulator manipulator) {
-        logStream << manipulator;
-        terminalStream << manipulator;
+        if(enabled)
+            stream() << manipulator;
         return *this;
     }
 
     Log& operator<<(const colors::Color& c) {
-        const std::string colorString = log::detail::ConsoleCommand::MakeString(c);
-        terminalStream << colorString;
+        if(LogWriter<L>::HasTerminal && enabled && numberOfColorMarks < MaxNumberOfColorMarks) {
+            const ColorMark mark = { static_cast<size_t>(stream().tellp()), c };
+            marks[numberOfColorMarks++] = mark;
+        }
         return *this;
     }
 
     void PrintTimestamp() {
-        const std::string timestampString = FullTimestampString();
-        logStream << timestampString << std::endl;
-        terminalStream << timestampString << std::endl;
+        if(enabled)
+            stream() << FullTimestampString() << std::endl;
     }
 
     static std::string TimestampString() {
-        std::ostringstream ss;
-        ss << "<" << DateTimeProvider::TimeNow() << ">";
-        return ss.str();
+        return DateTimeProvider::DecoratedTimeNow();
     }
 
     static std::string FullTimestampString() {
-        std::ostringstream ss;
-        ss << "<" << DateTimeProvider::Now() << ">";
-        return ss.str();
+        return DateTimeProvider::DecoratedNow();
     }
 
+private:
+    Log(const Log&);
+    Log& operator=(const Log&);
+
+    std::ostringstream& stream() { return *reinterpret_cast<std::ostringstream*>(&streamStorage); }
 
 private:
-    std::ostringstream logStream;
-    std::ostringstream terminalStream;
+    /// The message stream. It is constructed only if the log is enabled.
+    typename std::aligned_storage<sizeof(std::ostringstream), alignof(std::ostringstream)>::type streamStorage;
+    bool enabled;
+    ColorMark marks[MaxNumberOfColorMarks];
+    size_t numberOfColorMarks;
 };
 
 } // detail
+
+/*!
+ * \brief Writes log messages in a dedicated thread.
+ *
+ * While the writer is running, posting a message costs one allocation and one atomic exchange. All console and file
+ * output is done by the writer thread, which flushes the log files when \a flushSize bytes were written since the
+ * last flush or when \a flushInterval has passed, whichever comes first.
+ *
+ * On a crash (SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT or std::terminate) the handler asks the writer thread to
+ * stop consuming, waits until it leaves the queue, and then writes the buffered data and the queued messages with
+ * write(2) on the already open descriptors. It takes no locks and allocates nothing.
+ */
+class AsyncLogWriter {
+public:
+    static AsyncLogWriter& Singleton();
+
+    /*!
+     * \brief Start the writer thread. Does nothing if it is already started.
+     * \param flushSize - number of bytes after which the log files are flushed.
+     * \param flushInterval - maximal time that a message can stay in the queue or in the file buffer.
+     * \param installCrashHandlers - flush the queued messages on std::terminate and on fatal signals.
+     */
+    void Start(size_t flushSize, const Time& flushInterval, bool installCrashHandlers = true);
+
+    /// Write all queued messages, flush the log files and stop the writer thread.
+    void Stop();
+
+    /// Wait until all messages posted before this call are written and flushed.
+    void Flush();
+
+    /// Returns the number of messages that are waiting to be written.
+    size_t Backlog() const { return queue.Size(); }
+
+    ~AsyncLogWriter();
+
+private:
+    friend void detail::PushToAsyncWriter(detail::LogRecord&& record);
+
+    AsyncLogWriter();
+    void Push(detail::LogRecord&& record);
+    void Run();
+    void Drain();
+    void FlushFiles();
+    void EmergencyFlush();
+    static void OnTerminate();
+    static void OnFatalSignal(int signal);
+
+private:
+    MpscQueue<detail::LogRecord> queue;
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wakeUp, flushed;
+    std::atomic<bool> writerIsSleeping, stopRequested, flushRequested;
+
+    /// The crash handler sets emergencyRequested and waits until the writer is out of the queue and the files.
+    std::atomic<bool> emergencyRequested, writerIsBusy;
+    std::atomic<unsigned long> flushCount;
+    size_t flushSize;
+    std::chrono::microseconds flushInterval;
+};
+
 } // log
 
 typedef log::detail::Log<log::detail::Info> LogInfo;
@@ -25,7 +25,10 @@
 #include <QApplication>
 #include "exception.h"
 #include "ConfigParameters.h"
+#include "EventLog.h"
+#include "FileWatcher.h"
 #include "GuiController.h"
+#include "Trace.h"
 
 const std::string LOG_HEAD = "main";
 const std::string DEFAULT_LOG_FILE_NAME = "info.log";
@@ -37,23 +40,59 @@ int main(int argc, char *argv[])
     QApplication a(argc, argv);
     GuiController guiController;
     try {
-        ConfigParameters& configParameters = ConfigParameters::ModifiableSingleton();
-        configParameters.setDirectory(".");
-        configParameters.setDebugFileName(DEFAULT_DEBUG_LOG_FILE_NAME);
-        configParameters.setErrorFileName(DEFAULT_ERROR_LOG_FILE_NAME);
-        configParameters.setLogFileName(DEFAULT_LOG_FILE_NAME);
-        vsc::LogDebug().open( configParameters.FullDebugFileName() );
-        vsc::LogError().open( configParameters.FullDebugFileName() );
-        vsc::LogInfo ().open( configParameters.FullLogFileName() );
+        ConfigParameters::Update([](ConfigParameters& configParameters) {
+            configParameters.setDirectory(".");
+            configParameters.setDebugFileName(DEFAULT_DEBUG_LOG_FILE_NAME);
+            configParameters.setErrorFileName(DEFAULT_ERROR_LOG_FILE_NAME);
+            configParameters.setLogFileName(DEFAULT_LOG_FILE_NAME);
+        });
+        const ConfigParameters::Pointer configParameters = ConfigParameters::Singleton();
+        vsc::LogDebug().open( configParameters->FullDebugFileName() );
+        vsc::LogError().open( configParameters->FullDebugFileName() );
+        vsc::LogInfo ().open( configParameters->FullLogFileName() );
 
         vsc::LogInfo(LOG_HEAD) << "Starting... " << vsc::LogInfo::FullTimestampString() << std::endl;
 
-        configParameters.ReadConfigParameterFile();
+        ConfigParameters::Reload();
+        if(ConfigParameters::Singleton()->EventLogging())
+            vsc::EventLog::Singleton().Open(ConfigParameters::Singleton()->FullEventLogFileName());
     } catch(vsc::exception& e) {
         guiController.getMainWindow().ReportError(e);
     }
 
+    const ConfigParameters::Pointer configParameters = ConfigParameters::Singleton();
+    vsc::LogDebug::SetEnabled(configParameters->DebugLogging());
+    if(configParameters->AsynchronousLogging())
+        vsc::log::AsyncLogWriter::Singleton().Start(configParameters->LogFlushSize(),
+                                                    configParameters->LogFlushInterval());
+    if(configParameters->Tracing())
+        vsc::Tracer::Singleton().Enable(configParameters->TraceBufferSize());
+    vsc::Tracer::Singleton().SetThreadName("GUI");
+
+    std::unique_ptr<vsc::FileWatcher> configWatcher;
+    if(configParameters->ReloadOnConfigFileChange()) {
+        try {
+            configWatcher.reset(new vsc::FileWatcher(configParameters->FullConfigFileName(), [&guiController]() {
+                ConfigParameters::Reload();
+                vsc::LogInfo(LOG_HEAD) << "Configuration reloaded.\n";
+                guiController.getController().SendCommand(vsc::Controller::Command::ApplyConfiguration);
+            }));
+        } catch(vsc::exception& e) {
+            guiController.getMainWindow().ReportError(e);
+        }
+    }
+
     const int result = a.exec();
+    configWatcher.reset();
+    if(vsc::Tracer::Singleton().IsEnabled()) {
+        try {
+            vsc::Tracer::Singleton().Export(configParameters->FullTraceFileName());
+        } catch(vsc::exception& e) {
+            vsc::LogError(e.header()) << "ERROR: " << e.message() << std::endl;
+        }
+    }
     vsc::LogInfo(LOG_HEAD) << "Exiting... " << vsc::LogInfo::FullTimestampString() << std::endl;
+    vsc::log::AsyncLogWriter::Singleton().Stop();
+    vsc::EventLog::Singleton().Close();
     return result;
 }
@@ -28,6 +28,7 @@
 #include <boost/units/systems/si/current.hpp>
 #include <boost/units/systems/si/time.hpp>
 #include <boost/units/systems/si/resistance.hpp>
+#include <boost/units/systems/si/capacitance.hpp>
 #include <boost/units/io.hpp>
 
 namespace vsc {
@@ -36,6 +37,7 @@ using boost::units::si::amperes;
 using boost::units::si::volts;
 using boost::units::si::seconds;
 using boost::units::si::ohms;
+using boost::units::si::farads;
 
 /// Type definition for the electric potential.
 typedef boost::units::quantity<boost::units::si::electric_potential> ElectricPotential;
@@ -49,6 +51,9 @@ typedef boost::units::quantity<boost::units::si::time> Time;
 /// Type definition for the resistance.
 typedef boost::units::quantity<boost::units::si::resistance> Resistance;
 
+/// Type definition for the capacitance.
+typedef boost::units::quantity<boost::units::si::capacitance> Capacitance;
+
 typedef boost::mpl::divides<boost::units::current_dimension, boost::units::time_dimension>::type current_per_time_type;
 typedef boost::units::unit<current_per_time_type, boost::units::si::system> current_per_time;
 typedef boost::units::quantity<current_per_time> CurrentPerTime;
@@ -59,6 +64,7 @@ static const double kilo = 1e3;
 static const double milli = 1e-3;
 static const double micro = 1e-6;
 static const double nano = 1e-9;
+static const double pico = 1e-12;
 
 /// abs from boost/units/cmath.hpp
 template<class Unit, class Y>